@@ -0,0 +1,87 @@
+/*
+ * Micro-benchmark of IUPAC inclusion kernels against the previous
+ * IUPACMotif::includes loop. Not part of the package build:
+ *
+ *   g++ -O2 -std=c++11 bench/bench-inclusion.cpp src/Motifs/inclusion.cpp -o bench-inclusion
+ *   ./bench-inclusion
+ */
+
+#include "../src/Motifs/inclusion.h"
+
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// IUPACMotif::includes before the kernels were introduced
+static bool includesLegacy(const cell buf[], const cell otherBuf[], unsigned length) {
+    unsigned bufSize = (length - 1) / IUPAC_PER_CELL + 1;
+    bool result = true;
+    cell mask = 0x1111111111111111;
+    cell presentMask = 0xffffffffffffffff;
+    for (unsigned i = 0; i < bufSize && result; i++) {
+        if (i == bufSize-1 && length % IUPAC_PER_CELL != 0) {
+            presentMask = (1L << ((length % IUPAC_PER_CELL) * IUPAC_SIZE)) - 1L;
+            mask &= presentMask;
+        }
+
+        bool cond1 = (otherBuf[i] & ~buf[i] & presentMask) == 0;
+        cell X = otherBuf[i] & buf[i];
+        cell Y = (X | X >> 1 | X >> 2 | X >> 3);
+
+        bool cond2 = (Y & mask) == mask;
+        result &= cond1 && cond2;
+    }
+    return result;
+}
+
+static bool includesDispatched(const cell pattern[], const cell other[], unsigned length) {
+    return iupacIncludes(pattern, other, length);
+}
+
+static double run(InclusionKernel kernel, const std::vector<cell>& patterns,
+                  const std::vector<cell>& windows, unsigned cells, unsigned length,
+                  unsigned repeats, unsigned& hits) {
+    unsigned count = patterns.size() / cells;
+    auto start = std::chrono::steady_clock::now();
+    hits = 0;
+    for (unsigned r = 0; r < repeats; r++) {
+        for (unsigned i = 0; i < count; i++) {
+            hits += kernel(&patterns[i*cells], &windows[i*cells], length);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count() / repeats / count;
+}
+
+int main() {
+    const unsigned count = 4096, repeats = 2000;
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned> nucleotide(1, 15);
+
+    std::printf("%8s %10s %10s %10s %10s %10s  (ns per check)\n",
+                "length", "legacy", "scalar", "sse2", "avx2", "dispatch");
+    for (unsigned length : {8u, 16u, 32u, 64u, 128u, 256u}) {
+        unsigned cells = (length - 1) / IUPAC_PER_CELL + 1;
+        std::vector<cell> patterns(count * cells), windows(count * cells);
+        for (unsigned i = 0; i < count; i++) {
+            for (unsigned j = 0; j < length; j++) {
+                base p = nucleotide(rng);
+                putIUPAC(&patterns[i*cells], j, p);
+                // Matching windows force the kernels to look at every cell
+                putIUPAC(&windows[i*cells], j, (i % 8) ? p : nucleotide(rng));
+            }
+        }
+        unsigned hits[5];
+        double legacy = run(&includesLegacy, patterns, windows, cells, length, repeats, hits[0]);
+        double scalar = run(&includesScalar, patterns, windows, cells, length, repeats, hits[1]);
+        double sse2 = inclusionSSE2Supported() ?
+            run(&includesSSE2, patterns, windows, cells, length, repeats, hits[2]) : -1;
+        double avx2 = inclusionAVX2Supported() ?
+            run(&includesAVX2, patterns, windows, cells, length, repeats, hits[3]) : -1;
+        double dispatch = run(&includesDispatched, patterns, windows, cells, length, repeats, hits[4]);
+        std::printf("%8u %10.2f %10.2f %10.2f %10.2f %10.2f\n",
+                    length, legacy, scalar, sse2, avx2, dispatch);
+    }
+    return 0;
+}
@@ -5,6 +5,48 @@
 #include "Counters.h"
 
 class MotifCounterFactory {
+private:
+    typedef IMotifCounter* (*SpecificMotifCounterCreator)(
+            const DataStructureFactory& factory,
+            const std::vector<std::string> & geneNames,
+            const std::vector<std::string> & patterns,
+            bool rc
+    );
+
+    template<class Builder>
+    static IMotifCounter* createSpecificMotifCounter(
+            const DataStructureFactory& factory,
+            const std::vector<std::string> & geneNames,
+            const std::vector<std::string> & patterns,
+            bool rc
+    ) {
+        return new SpecificMotifCounterImpl<Builder>(factory, geneNames, patterns, rc);
+    }
+
+    /// Picks a builder specialized for the number of cells the longest pattern needs
+    static IMotifCounter* getSpecificMotifCounter(
+            const DataStructureFactory& factory,
+            const std::vector<std::string> & geneNames,
+            const std::vector<std::string> & patterns,
+            bool rc
+    ) {
+        static const SpecificMotifCounterCreator creators[SPECIFIC_MOTIF_COUNTER_MAX_CELLS] = {
+            &createSpecificMotifCounter<FixedIUPACMotifBuilder<1> >,
+            &createSpecificMotifCounter<FixedIUPACMotifBuilder<2> >,
+            &createSpecificMotifCounter<FixedIUPACMotifBuilder<3> >,
+            &createSpecificMotifCounter<FixedIUPACMotifBuilder<4> >
+        };
+        size_t length = SpecificMotifCounter::longestPattern(patterns);
+        if (length == 0) {
+            throw std::invalid_argument("Patterns must not be empty");
+        }
+        size_t cells = (length - 1) / IUPAC_PER_CELL + 1;
+        if (cells <= SPECIFIC_MOTIF_COUNTER_MAX_CELLS) {
+            return creators[cells-1](factory, geneNames, patterns, rc);
+        }
+        return createSpecificMotifCounter<IUPACMotifBuilder>(factory, geneNames, patterns, rc);
+    }
+
 public:
     MotifCounterFactory() {};
     ~MotifCounterFactory() {};
@@ -34,10 +76,10 @@ public:
 
             return new SimpleMotifCounter(factory, geneNames, k, rc);
         } else if (!mode.compare("specific_single")) {
-            auto pattern = counterParams["patterns"];
+            std::vector<std::string> pattern = counterParams["patterns"];
             bool rc = counterParams["rc"];
 
-            return new SpecificMotifCounter(factory, geneNames, pattern, rc);
+            return getSpecificMotifCounter(factory, geneNames, pattern, rc);
         } else if (!mode.compare("repeat")) {
             unsigned minSpacer = counterParams["minSpacer"];
             unsigned maxSpacer = counterParams["maxSpacer"];
@@ -22,12 +22,15 @@ RepeatCounter::RepeatCounter(
 
     presentKmerMap = std::vector<unsigned>(kmersTotal, 0);
 
+    // Labels may be generated after the counter is gone, so capture by value
+    unsigned kmersTotal = this->kmersTotal;
+    int window = this->window;
     const std::function<std::string (unsigned)> elementLabelGenerator =
-        [this](unsigned id){
-            unsigned kmer = id % this->kmersTotal;
-            int spacer = this->minSpacer + (int)(id / this->kmersTotal % (this->window+1));
-            unsigned orientation = id / this->kmersTotal / (this->window+1);
-            std::string label = Utils::intToString(kmer, this->k, true);
+        [kmersTotal, window, minSpacer, k](unsigned id){
+            unsigned kmer = id % kmersTotal;
+            int spacer = minSpacer + (int)(id / kmersTotal % (window+1));
+            unsigned orientation = id / kmersTotal / (window+1);
+            std::string label = Utils::intToString(kmer, k, true);
             switch(orientation) {
             case DIRECT:
                 return label + '_' + std::to_string(spacer) + '_' + label;
@@ -109,7 +112,9 @@ std::shared_ptr<IDataStructure> RepeatCounter::getResult() const {
 void RepeatCounter::init(const DataStructureFactory& factory,
                          const std::function<std::string (unsigned)> elementLabelGenerator,
                          const std::vector<std::string>& geneLabels) {
-    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels));
+    // IDs of all three orientations, see getID
+    uint64_t elementsTotal = (uint64_t)kmersTotal * (window+1) * 3;
+    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels, elementsTotal));
 }
 
 void RepeatCounter::initGene(unsigned gene) {
@@ -3,14 +3,14 @@
 
 #include "../DataStructures/DataStructureFactory.h"
 #include "IMotifCounter.h"
-#include "../Motifs/CompactMotifBuilder.h"
+#include "../Motifs/FixedCompactMotifBuilder.hpp"
 #include "MotifBuffer.hpp"
 #include <memory>
 
 class RepeatCounter: public IMotifCounter {
 private:
     int kmersTotal, k, window, minSpacer, maxSpacer;
-    CompactMotifBuilder builder;
+    FixedCompactMotifBuilder<1> builder; // k-mers always fit into one cell
     MotifBuffer<cell> buffer;
     std::vector<unsigned> presentKmerMap;
 
@@ -26,9 +26,9 @@ SimpleMotifCounter::SimpleMotifCounter(
 	plusAndMinus = Utils::getPlusMinusMapping(k);
 	kmersTotal = Utils::getKmersTotal(k);
 	std::function<std::string (unsigned)> elementLabelGenerator =
-	    [this](unsigned id) {
-	        std::string label = Utils::intToString(id, this->k, true);
-	        if (this->rc) {
+	    [k, rc](unsigned id) {
+	        std::string label = Utils::intToString(id, k, true);
+	        if (rc) {
 	            label += " | " + Utils::reverseComplement(label, true);
 	        }
 	        return label;
@@ -59,7 +59,7 @@ std::shared_ptr<IDataStructure> SimpleMotifCounter::getResult() const {
 void SimpleMotifCounter::init(const DataStructureFactory& factory,
                               const std::function<std::string (unsigned)> elementLabelGenerator,
                               const std::vector<std::string>& geneLabels) {
-    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels));
+    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels, kmersTotal));
 }
 
 void SimpleMotifCounter::initGene(unsigned gene) {
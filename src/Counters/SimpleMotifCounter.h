@@ -10,7 +10,7 @@
 
 #include "../DataStructures/MotifPositionsSparse.h"
 #include "IMotifCounter.h"
-#include "../Motifs/CompactMotifBuilder.h"
+#include "../Motifs/FixedCompactMotifBuilder.hpp"
 #include <memory>
 
 class SimpleMotifCounter: public IMotifCounter {
@@ -20,7 +20,7 @@ private:
     bool rc;
 	std::unique_ptr<unsigned[]> plusAndMinus;
 	std::shared_ptr<IDataStructure> result;
-	CompactMotifBuilder builder;
+	FixedCompactMotifBuilder<1> builder; // k-mers always fit into one cell
 public:
 	SimpleMotifCounter(const DataStructureFactory& factory,
                     const std::vector<std::string> & geneLabels,
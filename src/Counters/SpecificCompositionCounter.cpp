@@ -29,44 +29,37 @@ SpecificCompositionCounter::SpecificCompositionCounter(
     end(0),
     buffer(2*(maxSpacer+k)+1),
     validity(2*(maxSpacer+k)+1),
-    center(-maxSpacer-k-1)
+    center(-maxSpacer-k-1),
+    patterns(patterns, checkedLength(k), rc)
 {
-    unsigned limit = sizeof(unsigned) * 8 / COMPACT_SIZE;
-    if (k > limit) {
-        throw std::runtime_error("Error: coupling oligomer length has a limit of " + std::to_string(limit));
-    }
     plusAndMinus = Utils::getPlusMinusMapping(k);
     kmersTotal = Utils::getKmersTotal(k);
 
     // Generating labels
-    for(unsigned patternID = 0; patternID < patterns.size(); patternID++) {
-        std::string strPattern = patterns[patternID];
-        this -> patterns.push_back(Pattern(strPattern));
-        rcPatterns.push_back(Pattern(Utils::reverseComplement(strPattern)));
-    }
-
+    // Labels may be generated after the counter is gone, so capture by value
+    unsigned kmersTotal = this->kmersTotal;
+    int window = this->window;
     std::function<std::string (unsigned)> elementLabelGenerator =
-        [this, patterns](unsigned id) {
+        [patterns, kmersTotal, fuzzySpacer, minSpacer, maxSpacer, window, k](unsigned id) {
             int kmer, pattern, orientation, spacer;
             std::string strSpacer;
             kmer = id % kmersTotal;
-            //kmer = this->fuzzyOrientation && this->rc && ? this->plusAndMinus[kmer] : kmer;
             id /= kmersTotal;
-            if (this->fuzzySpacer) {
-                strSpacer = std::to_string(this->minSpacer) +
-                    ".." + std::to_string(this->maxSpacer);
+            if (fuzzySpacer) {
+                strSpacer = std::to_string(minSpacer) +
+                    ".." + std::to_string(maxSpacer);
             } else {
-                spacer = id % this->window + this->minSpacer;
-                id /= this->window;
+                spacer = id % window + minSpacer;
+                id /= window;
                 strSpacer = std::to_string(spacer);
             }
             pattern = id % patterns.size();
             orientation = id / patterns.size();
             if (!orientation) {
                 return patterns[pattern] + "_" + strSpacer +
-                    "_" + Utils::intToString(kmer, this->k, true);
+                    "_" + Utils::intToString(kmer, k, true);
             } else {
-                return Utils::intToString(kmer, this->k, true) +
+                return Utils::intToString(kmer, k, true) +
                     "_" + strSpacer + "_" + patterns[pattern];
             }
         };
@@ -90,6 +83,14 @@ std::shared_ptr<IDataStructure> SpecificCompositionCounter::getResult() const {
     return result;
 }
 
+unsigned SpecificCompositionCounter::checkedLength(unsigned k) {
+    unsigned limit = sizeof(unsigned) * 8 / COMPACT_SIZE;
+    if (k > limit) {
+        throw std::runtime_error("Error: coupling oligomer length has a limit of " + std::to_string(limit));
+    }
+    return k;
+}
+
 void SpecificCompositionCounter::step() {
     if (!buffer.full()) {
         center++;
@@ -102,12 +103,12 @@ void SpecificCompositionCounter::step() {
         return;
     }
     if (validity[center]) {
-        for (unsigned patternID = 0; patternID < patterns.size(); patternID++) {
-            if (patterns[patternID].check(buffer[center])) {
+        auto found = patterns.find(buffer[center]);
+        for (auto match = found.first; match != found.second; match++) {
+            unsigned patternID = match->pattern;
+            if (match->orientation & PatternIndex::FORWARD) {
                 for (int i = 0; i < end; i++) {
-                    if (i < center && (patterns[patternID].check(buffer[i]) ||
-                        (rc && rcPatterns[patternID].check(buffer[i]))
-                    )) {
+                    if (i < center && patterns.check(buffer[i], patternID)) {
                         continue;
                     }
                     if (abs(center - i) >= k+minSpacer && validity[i]) {
@@ -123,11 +124,9 @@ void SpecificCompositionCounter::step() {
                     }
                 }
             }
-            if (rc && (rcPatterns[patternID].check(buffer[center]))) {
+            if (match->orientation & PatternIndex::REVERSE) {
                 for (int i = 0; i < end; i++) {
-                    if (i < center && (patterns[patternID].check(buffer[i]) ||
-                        rcPatterns[patternID].check(buffer[i])
-                    )) {
+                    if (i < center && patterns.check(buffer[i], patternID)) {
                         continue;
                     }
                     if (abs(center - i) >= k+minSpacer && validity[i]) {
@@ -169,7 +168,9 @@ void SpecificCompositionCounter::count(unsigned nucleotide) {
 void SpecificCompositionCounter::init(const DataStructureFactory& factory,
                                       const std::function<std::string (unsigned)> elementLabelGenerator,
                                       const std::vector<std::string>& geneLabels) {
-    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels));
+    // Both pattern sides for every spacer, see getID
+    uint64_t elementsTotal = (uint64_t)kmersTotal * 2 * patterns.size() * (fuzzySpacer ? 1 : window);
+    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels, elementsTotal));
 }
 
 void SpecificCompositionCounter::finalizeGene() {
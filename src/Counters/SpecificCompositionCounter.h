@@ -1,11 +1,11 @@
 #ifndef COUNTERS_SPECIFICCOMPOSITIONCOUNTER_H_
 #define COUNTERS_SPECIFICCOMPOSITIONCOUNTER_H_
 
-#include "../Pattern/Pattern.h"
+#include "../Pattern/PatternIndex.h"
 #include <list>
 #include <boost/circular_buffer.hpp>
 #include <memory>
-#include "../Motifs/CompactMotifBuilder.h"
+#include "../Motifs/FixedCompactMotifBuilder.hpp"
 
 #include "IMotifCounter.h"
 
@@ -16,21 +16,21 @@ private:
     bool rc, fuzzySpacer, fuzzyOrder, fuzzyOrientation;
     unsigned kmersTotal;
 
-    std::vector<Pattern> patterns, rcPatterns;
-    std::vector<std::string> strPatterns;
-
     std::shared_ptr<IDataStructure> result;
 
     int window, k, end, center, minSpacer, maxSpacer, posOffset;
-    CompactMotifBuilder builder;
+    FixedCompactMotifBuilder<1> builder; // k-mers always fit into one cell
     boost::circular_buffer<unsigned> buffer;
     boost::circular_buffer<bool> validity;
+    // Initialized last, after k is checked
+    PatternIndex patterns;
 
     void step();
     inline void scroll(unsigned nucleotide);
 
     inline unsigned getID(unsigned kmer, unsigned pattern_id,
                           int spacer, bool pattern_left) const;
+    static unsigned checkedLength(unsigned k);
 public:
     SpecificCompositionCounter(
         const DataStructureFactory& factory,
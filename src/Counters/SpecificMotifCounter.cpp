@@ -1,7 +1,8 @@
 #include "SpecificMotifCounter.h"
 #include <algorithm>
 
-SpecificMotifCounter::SpecificMotifCounter(
+template<class Builder>
+SpecificMotifCounterImpl<Builder>::SpecificMotifCounterImpl(
     const DataStructureFactory& factory,
     const std::vector<std::string> & geneLabels,
     const std::vector<std::string> & patterns,
@@ -14,12 +15,19 @@ SpecificMotifCounter::SpecificMotifCounter(
 {
     std::function<std::string (unsigned)> elementLabelGenerator =
         [patterns](unsigned id){return patterns[id];};
-    init(factory, elementLabelGenerator, geneLabels);
     std::for_each(patterns.begin(), patterns.end(),
                    [this](std::string motif){this->patterns.push_back(IUPACMotif(motif));});
+    init(factory, elementLabelGenerator, geneLabels);
+    if (rc) {
+        for (const auto& pattern: this->patterns) {
+            std::unique_ptr<Motif> rcPattern(pattern.getReverseComplement());
+            rcPatterns.push_back(*static_cast<IUPACMotif *>(rcPattern.get()));
+        }
+    }
 }
 
-size_t SpecificMotifCounter::longestPattern(const std::vector<std::string> & patterns) {
+template<class Builder>
+size_t SpecificMotifCounterImpl<Builder>::longestPattern(const std::vector<std::string> & patterns) {
     size_t k = 0;
     for (const auto& pattern: patterns) {
         k = std::max(pattern.size(), k);
@@ -27,36 +35,51 @@ size_t SpecificMotifCounter::longestPattern(const std::vector<std::string> & pat
     return k;
 }
 
-void SpecificMotifCounter::initGene(unsigned gene){
+template<class Builder>
+void SpecificMotifCounterImpl<Builder>::initGene(unsigned gene){
     builder.clear();
     pos=0;
     result->sGeneInput(gene);
 }
 
-void SpecificMotifCounter::skip() {
+template<class Builder>
+void SpecificMotifCounterImpl<Builder>::skip() {
     pos++;
     builder.skip();
 }
 
-void SpecificMotifCounter::count(unsigned nucleotide){
+template<class Builder>
+void SpecificMotifCounterImpl<Builder>::count(unsigned nucleotide){
     builder.putCompact(nucleotide);
     pos++;
     for (unsigned i = 0; i < patterns.size(); i++) {
-        if (builder.matches(patterns[i], rc)) {
+        if (rc ? builder.matches(patterns[i], rcPatterns[i]) : builder.matches(patterns[i])) {
             result->sElementInput(i, pos);
         }
     }
 }
 
-void SpecificMotifCounter::init(const DataStructureFactory& factory,
+template<class Builder>
+void SpecificMotifCounterImpl<Builder>::init(const DataStructureFactory& factory,
                                 const std::function<std::string (unsigned)> elementLabelGenerator,
                   const std::vector<std::string>& geneLabels) {
-    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels));
+    result = std::shared_ptr<IDataStructure>(factory.create(elementLabelGenerator, geneLabels, patterns.size()));
 }
 
-void SpecificMotifCounter::finalizeGene() {}
+template<class Builder>
+void SpecificMotifCounterImpl<Builder>::finalizeGene() {}
 
-std::shared_ptr<IDataStructure> SpecificMotifCounter::getResult() const{
+template<class Builder>
+std::shared_ptr<IDataStructure> SpecificMotifCounterImpl<Builder>::getResult() const{
     return result;
 }
-SpecificMotifCounter::~SpecificMotifCounter() {}
+
+template<class Builder>
+SpecificMotifCounterImpl<Builder>::~SpecificMotifCounterImpl() {}
+
+// Must cover 1..SPECIFIC_MOTIF_COUNTER_MAX_CELLS
+template class SpecificMotifCounterImpl<IUPACMotifBuilder>;
+template class SpecificMotifCounterImpl<FixedIUPACMotifBuilder<1> >;
+template class SpecificMotifCounterImpl<FixedIUPACMotifBuilder<2> >;
+template class SpecificMotifCounterImpl<FixedIUPACMotifBuilder<3> >;
+template class SpecificMotifCounterImpl<FixedIUPACMotifBuilder<4> >;
@@ -2,29 +2,36 @@
 #define COUNTERS_SPECIFICMOTIFCOUNTER_H_
 
 #include "../Motifs/IUPACMotifBuilder.h"
+#include "../Motifs/FixedIUPACMotifBuilder.hpp"
 #include "IMotifCounter.h"
 
-class SpecificMotifCounter: public IMotifCounter {
+/**
+ * Builder is either IUPACMotifBuilder or FixedIUPACMotifBuilder<CELLS>,
+ * see MotifCounterFactory for the selection.
+ */
+template<class Builder>
+class SpecificMotifCounterImpl: public IMotifCounter {
 private:
     std::unique_ptr<unsigned[]> plusAndMinus;
     unsigned pos;
     bool rc;
-    IUPACMotifBuilder builder;
+    Builder builder;
 
-    std::vector<IUPACMotif> patterns;
+    std::vector<IUPACMotif> patterns, rcPatterns;
 
     std::shared_ptr<IDataStructure> result;
 
-    static size_t longestPattern(const std::vector<std::string> & patterns);
 public:
 
-    SpecificMotifCounter(
+    SpecificMotifCounterImpl(
         const DataStructureFactory& factory,
         const std::vector<std::string> & geneLabels,
         const std::vector<std::string> & patterns,
         bool rc
     );
 
+    static size_t longestPattern(const std::vector<std::string> & patterns);
+
     virtual void initGene(unsigned gene);
     virtual void skip();
     virtual void count(unsigned element);
@@ -33,8 +40,12 @@ public:
                       const std::vector<std::string>& geneLabels);
     virtual void finalizeGene();
     virtual std::shared_ptr<IDataStructure> getResult() const;
-    virtual ~SpecificMotifCounter();
+    virtual ~SpecificMotifCounterImpl();
 };
 
+/// Largest cell count with an explicitly instantiated fixed-size builder
+const unsigned SPECIFIC_MOTIF_COUNTER_MAX_CELLS = 4;
+
+typedef SpecificMotifCounterImpl<IUPACMotifBuilder> SpecificMotifCounter;
 
 #endif /* COUNTERS_SPECIFICMOTIFCOUNTER_H_ */
@@ -1,25 +1,37 @@
 #include "DataStructureFactory.h"
 #include "ElementCounts.h"
+#include "DenseElementCounts.h"
 #include "MotifPositions.h"
 #include "MotifPositionsSparse.h"
+#include "MotifPositionsCSR.h"
+#include "MotifPositionsBitmap.h"
 #include "GeneComposition.h"
+#include "GeneCountMatrix.h"
 #include <stdexcept>
 
 const std::map<std::string, DataStructureFactory::type> DataStructureFactory::dataTypeDict = {
     {"counts", DataStructureFactory::type::ElementCounts},
     {"genes", DataStructureFactory::type::MotifPositionsSparse},
     {"positions", DataStructureFactory::type::MotifPositions},
-    {"composition", DataStructureFactory::type::GeneComposition}
+    {"composition", DataStructureFactory::type::GeneComposition},
+    {"csr", DataStructureFactory::type::MotifPositionsCSR},
+    {"bitmap", DataStructureFactory::type::MotifPositionsBitmap},
+    {"matrix", DataStructureFactory::type::GeneCountMatrix}
 };
 
+const unsigned DataStructureFactory::DENSE_ELEMENTS_LIMIT;
+
 DataStructureFactory::DataStructureFactory() :
     _type(DataStructureFactory::type::MotifPositionsSparse),
-    createGCS("list")
+    createGCS("list"),
+    memoryBudget(0)
 {}
 
 DataStructureFactory::DataStructureFactory(const DataStructureFactory& other) :
     _type(other._type),
-    createGCS(other.createGCS)
+    createGCS(other.createGCS),
+    geneFilter(other.geneFilter),
+    memoryBudget(other.memoryBudget)
 {}
 
 void DataStructureFactory::setType(DataStructureFactory::type value) {
@@ -43,19 +55,49 @@ void DataStructureFactory::setCreateGCS(Rcpp::Function func) {
     createGCS = func;
 }
 
+void DataStructureFactory::setGeneFilter(const GeneFilter& filter) {
+    geneFilter = filter;
+}
+
+void DataStructureFactory::setMemoryBudget(size_t bytes) {
+    memoryBudget = bytes;
+}
+
 IDataStructure * DataStructureFactory::create(
         const std::function<std::string (unsigned)> elementLabelGenerator,
-        const std::vector<std::string>& geneLabels) const {
+        const std::vector<std::string>& geneLabels,
+        uint64_t elementsTotal) const {
+    IDataStructure * result;
     switch(_type) {
         case DataStructureFactory::type::MotifPositionsSparse:
-            return new MotifPositionsSparse(elementLabelGenerator, geneLabels, createGCS);
+            result = new MotifPositionsSparse(elementLabelGenerator, geneLabels, createGCS);
+            break;
         case DataStructureFactory::type::ElementCounts:
-            return new ElementCounts(elementLabelGenerator, geneLabels);
+            if (elementsTotal > 0 && elementsTotal <= DENSE_ELEMENTS_LIMIT) {
+                result = new DenseElementCounts(elementLabelGenerator, geneLabels, elementsTotal);
+            } else {
+                result = new ElementCounts(elementLabelGenerator, geneLabels);
+            }
+            break;
         case DataStructureFactory::type::MotifPositions:
-            return new MotifPositions(elementLabelGenerator, geneLabels);
+            result = new MotifPositions(elementLabelGenerator, geneLabels);
+            break;
         case DataStructureFactory::type::GeneComposition:
-            return new GeneComposition(elementLabelGenerator, geneLabels);
+            result = new GeneComposition(elementLabelGenerator, geneLabels);
+            break;
+        case DataStructureFactory::type::MotifPositionsCSR:
+            result = new MotifPositionsCSR(elementLabelGenerator, geneLabels, createGCS);
+            break;
+        case DataStructureFactory::type::MotifPositionsBitmap:
+            result = new MotifPositionsBitmap(elementLabelGenerator, geneLabels, createGCS);
+            break;
+        case DataStructureFactory::type::GeneCountMatrix:
+            result = new GeneCountMatrix(elementLabelGenerator, geneLabels, createGCS);
+            break;
         default:
             throw std::invalid_argument("Illegal data structure type");
     }
+    result->setGeneFilter(geneFilter);
+    result->setMemoryBudget(memoryBudget);
+    return result;
 }
@@ -2,13 +2,17 @@
 #define DATASTRUCTUREFACTORY_H_
 
 #include "IDataStructure.h"
+#include <cstdint>
 #include <functional>
 #include <map>
 
 class DataStructureFactory {
 public:
-    enum class type {ElementCounts, MotifPositionsSparse, MotifPositions, GeneComposition};
+    enum class type {ElementCounts, MotifPositionsSparse, MotifPositions, GeneComposition,
+                     MotifPositionsCSR, MotifPositionsBitmap, GeneCountMatrix};
     static const std::map<std::string, DataStructureFactory::type> dataTypeDict;
+    /// Largest element ID space for which counts are kept in a flat array
+    static const unsigned DENSE_ELEMENTS_LIMIT = 1 << 24;
     DataStructureFactory();
     DataStructureFactory(const DataStructureFactory&);
 
@@ -17,14 +21,25 @@ public:
     type getType() const;
 
     void setCreateGCS(Rcpp::Function func);
+    /// Gene support filter passed to every created structure
+    void setGeneFilter(const GeneFilter& filter);
+    /// Memory budget in bytes passed to every created structure, 0 for no limit
+    void setMemoryBudget(size_t bytes);
 
+    /**
+     * elementsTotal is the size of the counter's element ID space
+     * (all IDs passed to sElementInput are below it), 0 if unknown.
+     */
     virtual IDataStructure * create(const std::function<std::string (unsigned)> elementLabelGenerator,
-                            const std::vector<std::string>& geneLabels) const;
+                            const std::vector<std::string>& geneLabels,
+                            uint64_t elementsTotal = 0) const;
     virtual ~DataStructureFactory() {};
 
 private:
     type _type;
     Rcpp::Function createGCS;
+    GeneFilter geneFilter;
+    size_t memoryBudget;
 };
 
 #endif /* DATASTRUCTUREFACTORY_H_ */
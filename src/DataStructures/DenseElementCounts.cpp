@@ -0,0 +1,71 @@
+#include "DenseElementCounts.h"
+#include "ElementLabels.h"
+#include <algorithm>
+
+DenseElementCounts::DenseElementCounts(const std::function<std::string (unsigned)> elementLabelGenerator,
+                                       const std::vector<std::string>& geneLabels,
+                                       unsigned elementsTotal) :
+    elementLabelGenerator(elementLabelGenerator),
+    geneLabels(geneLabels),
+    counts(elementsTotal, 0)
+{}
+
+void DenseElementCounts::sGeneInput(unsigned gene) {}
+
+void DenseElementCounts::sElementInput(unsigned element, int position) {
+    if (element >= counts.size()) {
+        counts.resize(element + 1, 0);
+    }
+    counts[element]++;
+}
+
+unsigned DenseElementCounts::getElementCount() const{
+    return counts.size() - std::count(counts.begin(), counts.end(), 0);
+}
+
+unsigned DenseElementCounts::getGeneCount() const{
+    return geneLabels.size();
+}
+
+std::string DenseElementCounts::getElementLabel(unsigned element) const{
+    return elementLabelGenerator(element);
+}
+
+std::unordered_map<unsigned, std::string> DenseElementCounts::getElementLabels() const {
+    std::unordered_map<unsigned, std::string> result;
+    for (unsigned element = 0; element < counts.size(); element++) {
+        if (counts[element]) {
+            result[element] = getElementLabel(element);
+        }
+    }
+    return result;
+}
+
+const std::string& DenseElementCounts::getGeneLabel(unsigned gene) const{
+    return geneLabels[gene];
+}
+
+const std::vector<std::string>& DenseElementCounts::getGeneLabels() const{
+    return geneLabels;
+}
+
+const std::unordered_map<unsigned, std::vector<int>>& DenseElementCounts::getStructure() const {
+    return dummy;
+}
+
+const std::vector<uint32_t>& DenseElementCounts::getCounts() const {
+    return counts;
+}
+
+SEXP DenseElementCounts::getSEXP() const {
+    std::vector<unsigned> buffer, ids;
+    for (unsigned element = 0; element < counts.size(); element++) {
+        if (counts[element]) {
+            buffer.push_back(counts[element]);
+            ids.push_back(element);
+        }
+    }
+    Rcpp::NumericVector filteredData = Rcpp::wrap(buffer);
+    filteredData.attr("names") = makeElementLabels(ids, elementLabelGenerator);
+    return filteredData;
+}
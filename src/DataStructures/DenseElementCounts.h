@@ -0,0 +1,45 @@
+#ifndef DENSEELEMENTCOUNTS_H_
+#define DENSEELEMENTCOUNTS_H_
+
+#include "IDataStructure.h"
+#include <cstdint>
+#include <vector>
+#include <string>
+
+/**
+ * ElementCounts for counters with a small element ID space (e.g. all
+ * k-mers): one counter per possible ID in a flat array instead of a hash
+ * map. Chosen by DataStructureFactory, see DataStructureFactory::create.
+ */
+class DenseElementCounts : public IDataStructure {
+private:
+    const std::function<std::string (unsigned)> elementLabelGenerator;
+    const std::vector<std::string> geneLabels;
+
+    std::vector<uint32_t> counts;
+    std::unordered_map<unsigned, std::vector<int> > dummy;
+
+public:
+    DenseElementCounts(const std::function<std::string (unsigned)> elementLabelGenerator,
+                       const std::vector<std::string> & geneLabels,
+                       unsigned elementsTotal);
+
+    virtual void sGeneInput(unsigned gene);
+    virtual void sElementInput(unsigned element, int position);
+
+    virtual const std::unordered_map<unsigned, std::vector<int> >& getStructure() const;
+    /// Count of every element ID, zero for absent ones
+    const std::vector<uint32_t>& getCounts() const;
+
+    virtual SEXP getSEXP() const;
+
+    virtual unsigned getElementCount() const;
+    virtual unsigned getGeneCount() const;
+    virtual std::string getElementLabel(unsigned element) const;
+    virtual const std::string& getGeneLabel(unsigned gene) const;
+    virtual std::unordered_map<unsigned, std::string> getElementLabels() const;
+    virtual const std::vector<std::string> & getGeneLabels() const;
+    virtual ~DenseElementCounts() {};
+};
+
+#endif /* DENSEELEMENTCOUNTS_H_ */
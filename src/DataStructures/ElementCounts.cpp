@@ -1,12 +1,16 @@
 #include "ElementCounts.h"
+#include "ElementLabels.h"
 
 ElementCounts::ElementCounts(const std::function<std::string (unsigned)> elementLabelGenerator,
                              const std::vector<std::string>& geneLabels) :
     elementLabelGenerator(elementLabelGenerator),
     geneLabels(geneLabels),
-    curGene(0)
+    curGene(0),
+    spilled(false)
 {}
 
+const size_t ElementCounts::ENTRY_BYTES;
+
 void ElementCounts::sGeneInput(unsigned gene) {
     curGene = gene;
 }
@@ -14,13 +18,65 @@ void ElementCounts::sGeneInput(unsigned gene) {
 void ElementCounts::sElementInput(unsigned element, int position) {
     if (data.find(element) == data.end()) {
         data[element].push_back(1);
+        if (memoryBudget && data.size() * ENTRY_BYTES > memoryBudget) {
+            spill();
+        }
         return;
     }
     data[element][0]++;
 }
 
+void ElementCounts::spill() {
+    std::vector<Record> batch;
+    batch.reserve(data.size());
+    for (const auto& it : data) {
+        batch.push_back(Record{it.first, (unsigned)it.second[0]});
+    }
+    std::unordered_map<unsigned, std::vector<int>>().swap(data);
+    runs.write(batch);
+    spilled = true;
+}
+
+void ElementCounts::finalize() {
+    if (!spilled || runs.empty()) {
+        return;
+    }
+    spill();
+    runs.merge([this](const Record& record) {
+        if (!mergedElements.empty() && mergedElements.back() == record.element) {
+            mergedCounts.back() += record.count;
+        } else {
+            mergedElements.push_back(record.element);
+            mergedCounts.push_back(record.count);
+        }
+    });
+}
+
+bool ElementCounts::isSpilled() const {
+    return spilled;
+}
+
+const std::vector<unsigned>& ElementCounts::getMergedElements() const {
+    return mergedElements;
+}
+
+const std::vector<unsigned>& ElementCounts::getMergedCounts() const {
+    return mergedCounts;
+}
+
 unsigned ElementCounts::getElementCount() const{
-    return data.size();
+    return spilled ? mergedElements.size() : data.size();
+}
+
+std::unordered_map<unsigned, std::string> ElementCounts::getElementLabels() const {
+    if (!spilled) {
+        return IDataStructure::getElementLabels();
+    }
+    std::unordered_map<unsigned, std::string> result;
+    for (auto element : mergedElements) {
+        result[element] = getElementLabel(element);
+    }
+    return result;
 }
 
 unsigned ElementCounts::getGeneCount() const{
@@ -44,13 +100,17 @@ const std::unordered_map<unsigned, std::vector<int>>& ElementCounts::getStructur
 }
 
 SEXP ElementCounts::getSEXP() const {
-    std::vector<unsigned> buffer;
-    std::vector<std::string> nameBuffer;
-    for (auto it : data) {
+    if (spilled) {
+        Rcpp::NumericVector counts(mergedCounts.begin(), mergedCounts.end());
+        counts.attr("names") = makeElementLabels(mergedElements, elementLabelGenerator);
+        return counts;
+    }
+    std::vector<unsigned> buffer, ids;
+    for (const auto& it : data) {
         buffer.push_back(it.second[0]);
-        nameBuffer.push_back(elementLabelGenerator(it.first));
+        ids.push_back(it.first);
     }
     Rcpp::NumericVector filteredData = Rcpp::wrap(buffer);
-    filteredData.attr("names") = nameBuffer;
+    filteredData.attr("names") = makeElementLabels(ids, elementLabelGenerator);
     return filteredData;
 }
@@ -2,16 +2,37 @@
 #define ELEMENTCOUNTS_H_
 
 #include "IDataStructure.h"
+#include "SortedRuns.hpp"
 #include <vector>
 #include <string>
 
+/**
+ * Counts are kept in a hash map. When the map outgrows the memory budget
+ * it is spilled to disk as a sorted run of (element, count) records and
+ * cleared; finalize() merges the runs into flat sorted vectors. After a
+ * spill getStructure() is empty and getMergedElements()/getMergedCounts()
+ * hold the result. The budget bounds only the scan: the merged vectors are
+ * as large as the result.
+ */
 class ElementCounts : public IDataStructure {
 private:
+    struct Record {
+        unsigned element, count;
+    };
+    struct ByElement {
+        bool operator()(const Record& a, const Record& b) const { return a.element < b.element; }
+    };
+
     const std::vector<std::string> geneLabels;
     const std::function<std::string (unsigned)> elementLabelGenerator;
     unsigned curGene;
+    bool spilled;
 
     std::unordered_map<unsigned, std::vector<int>> data;
+    SortedRuns<Record, ByElement> runs;
+    std::vector<unsigned> mergedElements, mergedCounts;
+
+    void spill();
 
 public:
     ElementCounts(const std::function<std::string (unsigned)> elementLabelGenerator,
@@ -19,8 +40,16 @@ public:
 
     virtual void sGeneInput(unsigned gene);
     virtual void sElementInput(unsigned element, int position);
+    virtual void finalize();
+
+    /// Rough memory use of a map entry, for the budget
+    static const size_t ENTRY_BYTES = 96;
 
     virtual const std::unordered_map<unsigned, std::vector<int> >& getStructure() const;
+    bool isSpilled() const;
+    /// Sorted element IDs after a spill, valid after finalize()
+    const std::vector<unsigned>& getMergedElements() const;
+    const std::vector<unsigned>& getMergedCounts() const;
 
     virtual SEXP getSEXP() const;
 
@@ -28,6 +57,7 @@ public:
     virtual unsigned getGeneCount() const;
     virtual std::string getElementLabel(unsigned element) const;
     virtual const std::string& getGeneLabel(unsigned gene) const;
+    virtual std::unordered_map<unsigned, std::string> getElementLabels() const;
     virtual const std::vector<std::string> & getGeneLabels() const;
     virtual ~ElementCounts() {};
 };
@@ -0,0 +1,153 @@
+#include "ElementLabels.h"
+#include <Rversion.h>
+
+#ifdef R_VERSION
+#if R_VERSION >= R_Version(3, 6, 0)
+#include <R_ext/Altrep.h>
+#define ELEMENT_LABELS_ALTREP
+#endif
+#endif
+
+#ifdef ELEMENT_LABELS_ALTREP
+
+/*
+ * data1 is an external pointer to the Decoder, data2 is the cache of
+ * generated labels (R_NilValue until the first access). Labels are never
+ * empty, so R_BlankString marks a label which was not generated yet, until
+ * the cache is materialized: then every label is final, assigned ones
+ * included.
+ */
+namespace {
+
+struct Decoder {
+    std::vector<unsigned> ids;
+    std::function<std::string (unsigned)> generator;
+    bool materialized;
+};
+
+R_altrep_class_t labelsClass;
+
+Decoder * getDecoder(SEXP x) {
+    return static_cast<Decoder *>(R_ExternalPtrAddr(R_altrep_data1(x)));
+}
+
+void finalizeDecoder(SEXP ptr) {
+    delete static_cast<Decoder *>(R_ExternalPtrAddr(ptr));
+    R_ClearExternalPtr(ptr);
+}
+
+SEXP getCache(SEXP x) {
+    SEXP cache = R_altrep_data2(x);
+    if (cache == R_NilValue) {
+        cache = Rf_allocVector(STRSXP, getDecoder(x)->ids.size());
+        R_set_altrep_data2(x, cache);
+    }
+    return cache;
+}
+
+SEXP labelAt(SEXP x, R_xlen_t i) {
+    SEXP cache = getCache(x);
+    SEXP label = STRING_ELT(cache, i);
+    Decoder * decoder = getDecoder(x);
+    if (label == R_BlankString && !decoder->materialized) {
+        std::string text;
+        bool failed = false;
+        // Exceptions must not cross the R internals calling this
+        try {
+            text = decoder->generator(decoder->ids[i]);
+        } catch (...) {
+            failed = true;
+        }
+        if (failed) {
+            Rf_error("Can not generate element label");
+        }
+        label = Rf_mkCharCE(text.c_str(), CE_UTF8);
+        SET_STRING_ELT(cache, i, label);
+    }
+    return label;
+}
+
+SEXP materialize(SEXP x) {
+    SEXP cache = getCache(x);
+    Decoder * decoder = getDecoder(x);
+    if (!decoder->materialized) {
+        for (R_xlen_t i = 0; i < XLENGTH(cache); i++) {
+            labelAt(x, i);
+        }
+        decoder->materialized = true;
+    }
+    return cache;
+}
+
+R_xlen_t labelsLength(SEXP x) {
+    return getDecoder(x)->ids.size();
+}
+
+SEXP labelsElt(SEXP x, R_xlen_t i) {
+    return labelAt(x, i);
+}
+
+void labelsSetElt(SEXP x, R_xlen_t i, SEXP v) {
+    // Assigned labels may be blank, so the others are generated first
+    SET_STRING_ELT(materialize(x), i, v);
+}
+
+void * labelsDataptr(SEXP x, Rboolean writeable) {
+    return const_cast<SEXP *>(STRING_PTR_RO(materialize(x)));
+}
+
+const void * labelsDataptrOrNull(SEXP x) {
+    return NULL;
+}
+
+SEXP labelsDuplicate(SEXP x, Rboolean deep) {
+    return Rf_duplicate(materialize(x));
+}
+
+Rboolean labelsInspect(SEXP x, int pre, int deep, int pvec,
+                       void (*inspect_subtree)(SEXP, int, int, int)) {
+    Rprintf("lazy element labels (%d)\n", (int)labelsLength(x));
+    return TRUE;
+}
+
+void initLabelsClass() {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    labelsClass = R_make_altstring_class("element_labels", "metaRE", NULL);
+    R_set_altrep_Length_method(labelsClass, labelsLength);
+    R_set_altrep_Inspect_method(labelsClass, labelsInspect);
+    R_set_altrep_Duplicate_method(labelsClass, labelsDuplicate);
+    R_set_altvec_Dataptr_method(labelsClass, labelsDataptr);
+    R_set_altvec_Dataptr_or_null_method(labelsClass, labelsDataptrOrNull);
+    R_set_altstring_Elt_method(labelsClass, labelsElt);
+    R_set_altstring_Set_elt_method(labelsClass, labelsSetElt);
+    initialized = true;
+}
+
+}
+
+SEXP makeElementLabels(const std::vector<unsigned>& ids,
+                       const std::function<std::string (unsigned)>& elementLabelGenerator) {
+    initLabelsClass();
+    SEXP ptr = PROTECT(R_MakeExternalPtr(new Decoder({ids, elementLabelGenerator, false}),
+                                         R_NilValue, R_NilValue));
+    R_RegisterCFinalizerEx(ptr, finalizeDecoder, TRUE);
+    SEXP result = R_new_altrep(labelsClass, ptr, R_NilValue);
+    UNPROTECT(1);
+    return result;
+}
+
+#else
+
+SEXP makeElementLabels(const std::vector<unsigned>& ids,
+                       const std::function<std::string (unsigned)>& elementLabelGenerator) {
+    Rcpp::CharacterVector labels(ids.size());
+    for (unsigned i = 0; i < ids.size(); i++) {
+        labels[i] = elementLabelGenerator(ids[i]);
+    }
+    return labels;
+}
+
+#endif
@@ -0,0 +1,20 @@
+#ifndef ELEMENTLABELS_H_
+#define ELEMENTLABELS_H_
+
+#include <Rcpp.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+ * Character vector with elementLabelGenerator(ids[i]) as i-th item.
+ *
+ * With R >= 3.6 this is an ALTREP vector keeping only the IDs and the
+ * generator, a label is generated the first time it is accessed. The
+ * generator outlives the counter that made it, so it must not capture
+ * pointers to the counter. Older R versions get all labels right away.
+ */
+SEXP makeElementLabels(const std::vector<unsigned>& ids,
+                       const std::function<std::string (unsigned)>& elementLabelGenerator);
+
+#endif /* ELEMENTLABELS_H_ */
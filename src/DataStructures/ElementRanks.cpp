@@ -0,0 +1,35 @@
+#include "ElementRanks.h"
+#include <algorithm>
+#include <unordered_set>
+
+std::vector<unsigned> rankIds(std::vector<unsigned>& ids) {
+    std::vector<unsigned> sorted;
+    if (ids.empty()) {
+        return sorted;
+    }
+    unsigned maxId = *std::max_element(ids.begin(), ids.end());
+    // Direct lookup table while the ID space is comparable to the input
+    if (maxId / 4 < ids.size()) {
+        std::vector<unsigned> rank(maxId + 1, 0);
+        for (auto id : ids) {
+            rank[id] = 1;
+        }
+        for (unsigned id = 0; id <= maxId; id++) {
+            if (rank[id]) {
+                rank[id] = sorted.size();
+                sorted.push_back(id);
+            }
+        }
+        for (auto& id : ids) {
+            id = rank[id];
+        }
+    } else {
+        std::unordered_set<unsigned> distinct(ids.begin(), ids.end());
+        sorted.assign(distinct.begin(), distinct.end());
+        std::sort(sorted.begin(), sorted.end());
+        for (auto& id : ids) {
+            id = std::lower_bound(sorted.begin(), sorted.end(), id) - sorted.begin();
+        }
+    }
+    return sorted;
+}
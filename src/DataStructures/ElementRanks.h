@@ -0,0 +1,13 @@
+#ifndef ELEMENTRANKS_H_
+#define ELEMENTRANKS_H_
+
+#include <vector>
+
+/**
+ * Replaces every ID in ids by its rank among the distinct IDs and returns
+ * the distinct IDs in increasing order, so that result[ids[i]] is the
+ * original i-th ID. Only the distinct IDs are copied, not the column.
+ */
+std::vector<unsigned> rankIds(std::vector<unsigned>& ids);
+
+#endif /* ELEMENTRANKS_H_ */
@@ -0,0 +1,366 @@
+#include "GeneBitmap.h"
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <stdexcept>
+#include <cstdint>
+
+const unsigned GeneBitmap::ARRAY_LIMIT;
+
+static const unsigned BITMAP_WORDS = (1 << 16) / 64;
+
+GeneBitmap::Container& GeneBitmap::getContainer(uint16_t key) {
+    if (!containers.empty() && containers.back().key == key) {
+        return containers.back();
+    }
+    auto it = std::lower_bound(containers.begin(), containers.end(), key,
+        [](const Container& c, uint16_t key){ return c.key < key; });
+    if (it == containers.end() || it->key != key) {
+        it = containers.insert(it, Container({key, type::ARRAY, 0, {}, {}}));
+    }
+    return *it;
+}
+
+void GeneBitmap::toBitmap(Container& container) {
+    std::vector<uint64_t> bits(BITMAP_WORDS, 0);
+    if (container.kind == type::ARRAY) {
+        for (uint16_t value : container.values) {
+            bits[value >> 6] |= (uint64_t)1 << (value & 63);
+        }
+    } else if (container.kind == type::RUN) {
+        for (size_t i = 0; i < container.values.size(); i += 2) {
+            uint32_t last = (uint32_t)container.values[i] + container.values[i+1];
+            for (uint32_t value = container.values[i]; value <= last; value++) {
+                bits[value >> 6] |= (uint64_t)1 << (value & 63);
+            }
+        }
+    } else {
+        return;
+    }
+    container.kind = type::BITMAP;
+    container.bits.swap(bits);
+    std::vector<uint16_t>().swap(container.values);
+}
+
+void GeneBitmap::toArray(Container& container) {
+    if (container.kind == type::ARRAY) {
+        return;
+    }
+    std::vector<uint16_t> values = valuesOf(container);
+    container.kind = type::ARRAY;
+    container.values.swap(values);
+    std::vector<uint64_t>().swap(container.bits);
+}
+
+void GeneBitmap::add(uint32_t gene) {
+    Container& container = getContainer(gene >> 16);
+    uint16_t low = gene & 0xFFFF;
+    if (container.kind == type::RUN) {
+        toBitmap(container);
+    }
+    if (container.kind == type::BITMAP) {
+        uint64_t bit = (uint64_t)1 << (low & 63);
+        if (!(container.bits[low >> 6] & bit)) {
+            container.bits[low >> 6] |= bit;
+            container.cardinality++;
+        }
+        return;
+    }
+    auto& values = container.values;
+    if (values.empty() || values.back() < low) {
+        values.push_back(low);
+    } else {
+        auto it = std::lower_bound(values.begin(), values.end(), low);
+        if (*it == low) {
+            return;
+        }
+        values.insert(it, low);
+    }
+    container.cardinality++;
+    if (container.cardinality > ARRAY_LIMIT) {
+        toBitmap(container);
+    }
+}
+
+bool GeneBitmap::contains(uint32_t gene) const {
+    auto it = std::lower_bound(containers.begin(), containers.end(), (uint16_t)(gene >> 16),
+        [](const Container& c, uint16_t key){ return c.key < key; });
+    if (it == containers.end() || it->key != (gene >> 16)) {
+        return false;
+    }
+    uint16_t low = gene & 0xFFFF;
+    switch (it->kind) {
+        case type::ARRAY:
+            return std::binary_search(it->values.begin(), it->values.end(), low);
+        case type::BITMAP:
+            return it->bits[low >> 6] & ((uint64_t)1 << (low & 63));
+        case type::RUN:
+            for (size_t i = 0; i < it->values.size() && it->values[i] <= low; i += 2) {
+                if (low <= (uint32_t)it->values[i] + it->values[i+1]) {
+                    return true;
+                }
+            }
+            return false;
+    }
+    return false;
+}
+
+uint32_t GeneBitmap::cardinality() const {
+    uint32_t result = 0;
+    for (const auto& container : containers) {
+        result += container.cardinality;
+    }
+    return result;
+}
+
+void GeneBitmap::unite(const GeneBitmap& other) {
+    std::vector<Container> result;
+    result.reserve(containers.size() + other.containers.size());
+    auto a = containers.begin();
+    auto b = other.containers.begin();
+    while (a != containers.end() || b != other.containers.end()) {
+        if (b == other.containers.end() || (a != containers.end() && a->key < b->key)) {
+            result.push_back(std::move(*a++));
+        } else if (a == containers.end() || b->key < a->key) {
+            result.push_back(*b++);
+        } else {
+            Container merged = std::move(*a++);
+            Container added = *b++;
+            if (merged.kind == type::ARRAY && added.kind == type::ARRAY &&
+                    merged.cardinality + added.cardinality <= ARRAY_LIMIT) {
+                std::vector<uint16_t> values;
+                values.reserve(merged.cardinality + added.cardinality);
+                std::set_union(merged.values.begin(), merged.values.end(),
+                               added.values.begin(), added.values.end(),
+                               std::back_inserter(values));
+                merged.values.swap(values);
+                merged.cardinality = merged.values.size();
+            } else {
+                toBitmap(merged);
+                toBitmap(added);
+                merged.cardinality = 0;
+                for (unsigned i = 0; i < BITMAP_WORDS; i++) {
+                    merged.bits[i] |= added.bits[i];
+                    merged.cardinality += __builtin_popcountll(merged.bits[i]);
+                }
+            }
+            result.push_back(std::move(merged));
+        }
+    }
+    containers.swap(result);
+}
+
+uint32_t GeneBitmap::intersectionCount(const std::vector<uint64_t>& bitset) const {
+    uint32_t result = 0;
+    for (const auto& container : containers) {
+        size_t base = (size_t)container.key * BITMAP_WORDS;
+        if (base >= bitset.size()) {
+            break;
+        }
+        switch (container.kind) {
+            case type::ARRAY:
+                for (uint16_t value : container.values) {
+                    size_t word = base + (value >> 6);
+                    if (word < bitset.size()) {
+                        result += (bitset[word] >> (value & 63)) & 1;
+                    }
+                }
+                break;
+            case type::BITMAP: {
+                size_t words = std::min<size_t>(BITMAP_WORDS, bitset.size() - base);
+                for (size_t i = 0; i < words; i++) {
+                    result += __builtin_popcountll(container.bits[i] & bitset[base + i]);
+                }
+                break;
+            }
+            case type::RUN:
+                for (size_t i = 0; i < container.values.size(); i += 2) {
+                    size_t first = base * 64 + container.values[i];
+                    size_t last = std::min(first + container.values[i+1], bitset.size() * 64 - 1);
+                    for (size_t word = first >> 6; first <= last; word++) {
+                        size_t end = std::min(last, word * 64 + 63);
+                        uint64_t mask = ~(uint64_t)0 >> (63 - (end - first));
+                        result += __builtin_popcountll((bitset[word] >> (first & 63)) & mask);
+                        first = end + 1;
+                    }
+                }
+                break;
+        }
+    }
+    return result;
+}
+
+void GeneBitmap::runOptimize() {
+    for (auto& container : containers) {
+        std::vector<uint16_t> runs;
+        for (uint16_t low : valuesOf(container)) {
+            if (!runs.empty() && (uint32_t)runs[runs.size()-2] + runs.back() + 1 == low) {
+                runs.back()++;
+            } else {
+                runs.push_back(low);
+                runs.push_back(0);
+            }
+        }
+        size_t arrayBytes = container.cardinality <= ARRAY_LIMIT ? container.cardinality * 2 : SIZE_MAX;
+        size_t bitmapBytes = BITMAP_WORDS * 8;
+        size_t runBytes = runs.size() * 2;
+        if (runBytes < std::min(arrayBytes, bitmapBytes)) {
+            container.kind = type::RUN;
+            container.values.swap(runs);
+            std::vector<uint64_t>().swap(container.bits);
+        } else if (arrayBytes <= bitmapBytes) {
+            toArray(container);
+        } else {
+            toBitmap(container);
+        }
+    }
+}
+
+std::vector<uint16_t> GeneBitmap::valuesOf(const Container& container) {
+    if (container.kind == type::ARRAY) {
+        return container.values;
+    }
+    std::vector<uint16_t> values;
+    values.reserve(container.cardinality);
+    if (container.kind == type::BITMAP) {
+        for (unsigned i = 0; i < BITMAP_WORDS; i++) {
+            for (uint64_t word = container.bits[i]; word; word &= word - 1) {
+                values.push_back(i * 64 + __builtin_ctzll(word));
+            }
+        }
+    } else {
+        for (size_t i = 0; i < container.values.size(); i += 2) {
+            uint32_t last = (uint32_t)container.values[i] + container.values[i+1];
+            for (uint32_t value = container.values[i]; value <= last; value++) {
+                values.push_back(value);
+            }
+        }
+    }
+    return values;
+}
+
+std::vector<uint32_t> GeneBitmap::toVector() const {
+    std::vector<uint32_t> result;
+    result.reserve(cardinality());
+    for (const auto& container : containers) {
+        for (uint16_t low : valuesOf(container)) {
+            result.push_back(((uint32_t)container.key << 16) | low);
+        }
+    }
+    return result;
+}
+
+/*
+ * Serialized layout, native byte order:
+ * per container: key (2 bytes), type (1 byte), cardinality (4 bytes),
+ * payload size in 16 bit values (4 bytes), payload.
+ */
+template<class T>
+static void append(std::vector<uint8_t>& buffer, const T * data, size_t count) {
+    const uint8_t * bytes = reinterpret_cast<const uint8_t *>(data);
+    buffer.insert(buffer.end(), bytes, bytes + count * sizeof(T));
+}
+
+template<class T>
+static void extract(const uint8_t *& data, const uint8_t * end, T * target, size_t count) {
+    if ((size_t)(end - data) < count * sizeof(T)) {
+        throw std::invalid_argument("Corrupted gene bitmap");
+    }
+    std::memcpy(target, data, count * sizeof(T));
+    data += count * sizeof(T);
+}
+
+std::vector<uint8_t> GeneBitmap::serialize() const {
+    std::vector<uint8_t> buffer;
+    for (const auto& container : containers) {
+        uint8_t kind = (uint8_t)container.kind;
+        uint32_t size = container.kind == type::BITMAP ?
+            BITMAP_WORDS * 4 : container.values.size();
+        append(buffer, &container.key, 1);
+        append(buffer, &kind, 1);
+        append(buffer, &container.cardinality, 1);
+        append(buffer, &size, 1);
+        if (container.kind == type::BITMAP) {
+            append(buffer, container.bits.data(), BITMAP_WORDS);
+        } else {
+            append(buffer, container.values.data(), size);
+        }
+    }
+    return buffer;
+}
+
+GeneBitmap GeneBitmap::deserialize(const uint8_t * data, size_t size) {
+    // The data comes from R, so sizes are checked before anything is
+    // allocated, containers must be well formed and cardinalities are
+    // recounted instead of trusted
+    auto corrupted = []() { return std::invalid_argument("Corrupted gene bitmap"); };
+    GeneBitmap result;
+    const uint8_t * end = data + size;
+    while (data < end) {
+        Container container({0, type::ARRAY, 0, {}, {}});
+        uint8_t kind;
+        uint32_t payload;
+        extract(data, end, &container.key, 1);
+        extract(data, end, &kind, 1);
+        extract(data, end, &container.cardinality, 1);
+        extract(data, end, &payload, 1);
+        if (kind > (uint8_t)type::RUN || (size_t)(end - data) / sizeof(uint16_t) < payload) {
+            throw corrupted();
+        }
+        if (!result.containers.empty() && result.containers.back().key >= container.key) {
+            throw corrupted();
+        }
+        container.kind = (type)kind;
+        uint32_t cardinality = 0;
+        if (container.kind == type::BITMAP) {
+            if (payload != BITMAP_WORDS * 4) {
+                throw corrupted();
+            }
+            container.bits.resize(BITMAP_WORDS);
+            extract(data, end, container.bits.data(), BITMAP_WORDS);
+            for (uint64_t word : container.bits) {
+                cardinality += __builtin_popcountll(word);
+            }
+        } else {
+            if (container.kind == type::RUN && payload % 2) {
+                throw corrupted();
+            }
+            container.values.resize(payload);
+            extract(data, end, container.values.data(), payload);
+            const auto& values = container.values;
+            if (container.kind == type::ARRAY) {
+                for (size_t i = 1; i < values.size(); i++) {
+                    if (values[i - 1] >= values[i]) {
+                        throw corrupted();
+                    }
+                }
+                cardinality = payload;
+            } else {
+                uint32_t next = 0;
+                for (size_t i = 0; i < values.size(); i += 2) {
+                    uint32_t last = (uint32_t)values[i] + values[i + 1];
+                    if (values[i] < next || last > 0xFFFF) {
+                        throw corrupted();
+                    }
+                    cardinality += values[i + 1] + 1;
+                    next = last + 2;
+                }
+            }
+        }
+        if (cardinality != container.cardinality) {
+            throw corrupted();
+        }
+        result.containers.push_back(std::move(container));
+    }
+    return result;
+}
+
+std::vector<uint64_t> GeneBitmap::makeBitset(const std::vector<uint32_t>& genes, uint32_t total) {
+    std::vector<uint64_t> bitset((total + 63) / 64, 0);
+    for (uint32_t gene : genes) {
+        if (gene < total) {
+            bitset[gene >> 6] |= (uint64_t)1 << (gene & 63);
+        }
+    }
+    return bitset;
+}
@@ -0,0 +1,61 @@
+#ifndef GENEBITMAP_H_
+#define GENEBITMAP_H_
+
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Compressed set of gene indices in the spirit of roaring bitmaps.
+ * Genes are split by the high 16 bits into containers, each container is
+ * either a sorted array (up to ARRAY_LIMIT genes), a 2^16 bit bitmap or a
+ * list of runs (only after runOptimize()). Containers are kept sorted by
+ * key, genes are expected to be added mostly in increasing order.
+ */
+class GeneBitmap {
+public:
+    static const unsigned ARRAY_LIMIT = 4096;
+
+    GeneBitmap() {};
+
+    void add(uint32_t gene);
+    bool contains(uint32_t gene) const;
+    uint32_t cardinality() const;
+    bool empty() const { return containers.empty(); };
+
+    /// In place union
+    void unite(const GeneBitmap& other);
+    /// Number of genes which are set in a dense bitset indexed by gene
+    uint32_t intersectionCount(const std::vector<uint64_t>& bitset) const;
+    /// Converts containers to runs where this takes less memory
+    void runOptimize();
+
+    std::vector<uint32_t> toVector() const;
+    std::vector<uint8_t> serialize() const;
+    static GeneBitmap deserialize(const uint8_t * data, size_t size);
+
+    /// Dense bitset with the given genes set, for intersectionCount
+    static std::vector<uint64_t> makeBitset(const std::vector<uint32_t>& genes, uint32_t total);
+
+private:
+    enum class type : uint8_t {ARRAY, BITMAP, RUN};
+
+    struct Container {
+        uint16_t key;
+        type kind;
+        uint32_t cardinality;
+        /// Sorted values for ARRAY, (start, length-1) pairs for RUN
+        std::vector<uint16_t> values;
+        /// 1024 words for BITMAP
+        std::vector<uint64_t> bits;
+    };
+
+    std::vector<Container> containers;
+
+    Container& getContainer(uint16_t key);
+    static std::vector<uint16_t> valuesOf(const Container& container);
+    static void toBitmap(Container& container);
+    static void toArray(Container& container);
+};
+
+#endif /* GENEBITMAP_H_ */
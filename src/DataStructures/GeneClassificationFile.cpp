@@ -0,0 +1,182 @@
+#include "GeneClassificationFile.h"
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+const char GeneClassificationFile::MAGIC[8] = {'M', 'E', 'T', 'A', 'R', 'E', 'G', 'C'};
+const uint32_t GeneClassificationFile::VERSION;
+
+void GeneClassificationFile::write(const std::string& path, const int * offsets, const int * genes,
+                                   const std::vector<std::string>& elementNames,
+                                   const std::vector<std::string>& geneNames) {
+    Header header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = VERSION;
+    header.elementCount = elementNames.size();
+    header.geneCount = geneNames.size();
+    header.reserved = 0;
+    header.genesCount = offsets[elementNames.size()];
+
+    std::vector<uint64_t> labelOffsets(1, 0);
+    for (const auto& name : elementNames) {
+        labelOffsets.push_back(labelOffsets.back() + name.size());
+    }
+    for (const auto& name : geneNames) {
+        labelOffsets.push_back(labelOffsets.back() + name.size());
+    }
+
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char *>(labelOffsets.data()), labelOffsets.size() * sizeof(uint64_t));
+    out.write(reinterpret_cast<const char *>(offsets), (elementNames.size() + 1) * sizeof(int));
+    out.write(reinterpret_cast<const char *>(genes), header.genesCount * sizeof(int));
+    for (const auto& name : elementNames) {
+        out.write(name.data(), name.size());
+    }
+    for (const auto& name : geneNames) {
+        out.write(name.data(), name.size());
+    }
+    out.close();
+    if (!out) {
+        throw std::runtime_error("Can not write gene classification to " + path);
+    }
+}
+
+GeneClassificationFile::GeneClassificationFile(const std::string& path) :
+    data(nullptr),
+    size(0),
+    mapped(false)
+{
+    read(path);
+    validate(path);
+}
+
+void GeneClassificationFile::read(const std::string& path) {
+#ifndef _WIN32
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error("Can not open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size >= (off_t)sizeof(Header)) {
+        void * address = mmap(nullptr, info.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        if (address != MAP_FAILED) {
+            data = static_cast<char *>(address);
+            size = info.st_size;
+            mapped = true;
+        }
+    }
+    close(fd);
+    if (mapped) {
+        return;
+    }
+#endif
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+    if (!in) {
+        throw std::runtime_error("Can not open " + path);
+    }
+    buffer.resize(in.tellg());
+    in.seekg(0);
+    in.read(buffer.data(), buffer.size());
+    if (!in) {
+        throw std::runtime_error("Can not read " + path);
+    }
+    data = buffer.data();
+    size = buffer.size();
+}
+
+void GeneClassificationFile::validate(const std::string& path) {
+    if (size < sizeof(Header)) {
+        throw std::runtime_error(path + " is not a gene classification file");
+    }
+    header = reinterpret_cast<const Header *>(data);
+    if (std::memcmp(header->magic, MAGIC, sizeof(MAGIC)) != 0) {
+        throw std::runtime_error(path + " is not a gene classification file");
+    }
+    if (header->version != VERSION) {
+        throw std::runtime_error(path + " has unsupported version " + std::to_string(header->version));
+    }
+
+    uint64_t labelCount = (uint64_t)header->elementCount + header->geneCount + 1;
+    uint64_t labelsStart = sizeof(Header) + labelCount * sizeof(uint64_t) +
+        ((uint64_t)header->elementCount + 1 + header->genesCount) * sizeof(int);
+    if (labelsStart > size) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    labelOffsets = reinterpret_cast<const uint64_t *>(data + sizeof(Header));
+    offsets = reinterpret_cast<int *>(data + sizeof(Header) + labelCount * sizeof(uint64_t));
+    genes = offsets + header->elementCount + 1;
+    labels = data + labelsStart;
+    if (labelsStart + labelOffsets[labelCount - 1] != size) {
+        throw std::runtime_error(path + " is truncated");
+    }
+    if (offsets[0] != 0 || (uint64_t)offsets[header->elementCount] != header->genesCount) {
+        throw std::runtime_error(path + " has corrupt offsets");
+    }
+    // Same checks as GeneClassificationCSR in R, readers index with them unchecked
+    for (uint32_t element = 0; element < header->elementCount; element++) {
+        if (offsets[element] > offsets[element + 1]) {
+            throw std::runtime_error(path + " has corrupt offsets");
+        }
+    }
+    for (uint64_t gene = 0; gene < header->genesCount; gene++) {
+        if (genes[gene] < 1 || (uint32_t)genes[gene] > header->geneCount) {
+            throw std::runtime_error(path + " has genes out of range");
+        }
+    }
+}
+
+GeneClassificationFile::~GeneClassificationFile() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(data, size);
+    }
+#endif
+}
+
+unsigned GeneClassificationFile::getElementCount() const {
+    return header->elementCount;
+}
+
+unsigned GeneClassificationFile::getGeneCount() const {
+    return header->geneCount;
+}
+
+uint64_t GeneClassificationFile::getGenesCount() const {
+    return header->genesCount;
+}
+
+int * GeneClassificationFile::getOffsets() const {
+    return offsets;
+}
+
+int * GeneClassificationFile::getGenes() const {
+    return genes;
+}
+
+bool GeneClassificationFile::isMapped() const {
+    return mapped;
+}
+
+std::string GeneClassificationFile::getLabel(uint64_t label) const {
+    uint64_t first = labelOffsets[label], last = labelOffsets[label + 1];
+    if (first > last || last > labelOffsets[(uint64_t)header->elementCount + header->geneCount]) {
+        throw std::runtime_error("Corrupt label offsets in a gene classification file");
+    }
+    return std::string(labels + first, labels + last);
+}
+
+std::string GeneClassificationFile::getElementName(unsigned element) const {
+    return getLabel(element);
+}
+
+std::string GeneClassificationFile::getGeneName(unsigned gene) const {
+    return getLabel((uint64_t)header->elementCount + gene);
+}
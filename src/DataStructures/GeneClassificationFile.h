@@ -0,0 +1,75 @@
+#ifndef GENECLASSIFICATIONFILE_H_
+#define GENECLASSIFICATIONFILE_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Versioned binary file with the same data as a GeneClassificationCSR.
+ * Every section is an array of native endian integers, so a reader can map
+ * the file into memory and use the sections in place:
+ *
+ *   Header        32 bytes, see below
+ *   labelOffsets  uint64[elementCount + geneCount + 1], offsets in labels
+ *   offsets       int32[elementCount + 1]
+ *   genes         int32[genesCount], 1-based gene indices
+ *   labels        element labels followed by gene labels, no separators
+ *
+ * Files are not portable between machines with different endianness.
+ */
+class GeneClassificationFile {
+public:
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t elementCount;
+        uint32_t geneCount;
+        uint32_t reserved;
+        uint64_t genesCount;
+    };
+    static const char MAGIC[8];
+    static const uint32_t VERSION = 1;
+
+    /**
+     * Opens the file, mapping it into memory where the platform allows.
+     * Sections are mapped copy-on-write, so changes never reach the file.
+     * Throws std::runtime_error if the file is missing or malformed.
+     */
+    explicit GeneClassificationFile(const std::string& path);
+    GeneClassificationFile(const GeneClassificationFile&) = delete;
+    GeneClassificationFile& operator=(const GeneClassificationFile&) = delete;
+    ~GeneClassificationFile();
+
+    /// offsets has elementNames.size()+1 items, genes has offsets[elementNames.size()]
+    static void write(const std::string& path, const int * offsets, const int * genes,
+                      const std::vector<std::string>& elementNames,
+                      const std::vector<std::string>& geneNames);
+
+    unsigned getElementCount() const;
+    unsigned getGeneCount() const;
+    uint64_t getGenesCount() const;
+    int * getOffsets() const;
+    int * getGenes() const;
+    std::string getElementName(unsigned element) const;
+    std::string getGeneName(unsigned gene) const;
+    bool isMapped() const;
+
+private:
+    char * data;
+    size_t size;
+    bool mapped;
+    std::vector<char> buffer;
+
+    const Header * header;
+    const uint64_t * labelOffsets;
+    int * offsets;
+    int * genes;
+    const char * labels;
+
+    void read(const std::string& path);
+    void validate(const std::string& path);
+    std::string getLabel(uint64_t label) const;
+};
+
+#endif /* GENECLASSIFICATIONFILE_H_ */
@@ -0,0 +1,152 @@
+#include "GeneCountMatrix.h"
+#include "ElementRanks.h"
+#include "ElementLabels.h"
+#include <algorithm>
+#include <numeric>
+
+GeneCountMatrix::GeneCountMatrix(const std::function<std::string (unsigned)> elementLabelGenerator,
+                                 const std::vector<std::string>& geneLabels, Rcpp::Function createGCS) :
+    elementLabelGenerator(elementLabelGenerator),
+    geneLabels(geneLabels),
+    createGCS(createGCS),
+    finalized(false),
+    currentGene(0)
+{}
+
+void GeneCountMatrix::closeSegment() {
+    std::sort(segment.begin(), segment.end());
+    for (auto it = segment.begin(); it != segment.end();) {
+        auto next = std::upper_bound(it, segment.end(), *it);
+        cooElements.push_back(*it);
+        cooGenes.push_back(currentGene);
+        cooCounts.push_back(next - it);
+        it = next;
+    }
+    segment.clear();
+}
+
+void GeneCountMatrix::sGeneInput(unsigned gene) {
+    closeSegment();
+    currentGene = gene;
+}
+
+void GeneCountMatrix::sElementInput(unsigned element, int position) {
+    segment.push_back(element);
+}
+
+void GeneCountMatrix::finalize() {
+    if (finalized) {
+        return;
+    }
+    finalized = true;
+    closeSegment();
+    elements = rankIds(cooElements);
+
+    // Counting sort of triples by gene, then stable counting sort by element
+    unsigned genesTotal = geneLabels.size();
+    for (auto gene : cooGenes) {
+        genesTotal = std::max(genesTotal, gene + 1);
+    }
+    std::vector<unsigned> byGene(cooGenes.size()), order(cooGenes.size());
+    std::vector<unsigned> next(genesTotal + 1, 0);
+    for (auto gene : cooGenes) {
+        next[gene + 1]++;
+    }
+    std::partial_sum(next.begin(), next.end(), next.begin());
+    for (unsigned i = 0; i < cooGenes.size(); i++) {
+        byGene[next[cooGenes[i]]++] = i;
+    }
+
+    next.assign(elements.size() + 1, 0);
+    for (auto element : cooElements) {
+        next[element + 1]++;
+    }
+    std::partial_sum(next.begin(), next.end(), next.begin());
+    for (auto i : byGene) {
+        order[next[cooElements[i]]++] = i;
+    }
+
+    // Triples of a gene entered more than once are now adjacent
+    offsets.assign(elements.size() + 1, 0);
+    for (auto i : order) {
+        unsigned element = cooElements[i];
+        if (offsets[element + 1] > 0 && genes.back() == cooGenes[i]) {
+            counts.back() += cooCounts[i];
+        } else {
+            offsets[element + 1]++;
+            genes.push_back(cooGenes[i]);
+            counts.push_back(cooCounts[i]);
+        }
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    std::vector<unsigned>().swap(segment);
+    std::vector<unsigned>().swap(cooElements);
+    std::vector<unsigned>().swap(cooGenes);
+    std::vector<unsigned>().swap(cooCounts);
+    filterElements();
+}
+
+void GeneCountMatrix::filterElements() {
+    if (!geneFilter.isActive()) {
+        return;
+    }
+    geneFilter.compact(elements, offsets, GeneFilter::rowCounts(offsets), genes, counts);
+}
+
+unsigned GeneCountMatrix::getElementCount() const{
+    return elements.size();
+}
+
+unsigned GeneCountMatrix::getGeneCount() const{
+    return geneLabels.size();
+}
+
+std::string GeneCountMatrix::getElementLabel(unsigned element) const{
+    return elementLabelGenerator(element);
+}
+
+std::unordered_map<unsigned, std::string> GeneCountMatrix::getElementLabels() const {
+    std::unordered_map<unsigned, std::string> result;
+    for (auto element : elements) {
+        result[element] = getElementLabel(element);
+    }
+    return result;
+}
+
+const std::string& GeneCountMatrix::getGeneLabel(unsigned gene) const{
+    return geneLabels[gene];
+}
+
+const std::vector<std::string>& GeneCountMatrix::getGeneLabels() const{
+    return geneLabels;
+}
+
+const std::unordered_map<unsigned, std::vector<int> >& GeneCountMatrix::getStructure() const {
+    return dummy;
+}
+
+const std::vector<unsigned>& GeneCountMatrix::getElements() const {
+    return elements;
+}
+
+const std::vector<unsigned>& GeneCountMatrix::getOffsets() const {
+    return offsets;
+}
+
+const std::vector<unsigned>& GeneCountMatrix::getGenes() const {
+    return genes;
+}
+
+const std::vector<unsigned>& GeneCountMatrix::getCounts() const {
+    return counts;
+}
+
+SEXP GeneCountMatrix::getSEXP() const {
+    Rcpp::RObject elementNames = makeElementLabels(elements, elementLabelGenerator);
+    Rcpp::IntegerVector i(genes.begin(), genes.end());
+    Rcpp::IntegerVector p(offsets.begin(), offsets.end());
+    Rcpp::NumericVector x(counts.begin(), counts.end());
+
+    return createGCS(i, p, x, elementNames, Rcpp::wrap(geneLabels));
+}
@@ -0,0 +1,65 @@
+#ifndef GENECOUNTMATRIX_H_
+#define GENECOUNTMATRIX_H_
+
+#include "IDataStructure.h"
+#include <Rcpp.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+ * Number of occurrences of every element in every gene, stored as a sparse
+ * genes x elements matrix in compressed sparse column form: column i is
+ * getElements()[i], its rows are getGenes()[getOffsets()[i]..getOffsets()[i+1])
+ * (in increasing order) with values at the same indices of getCounts().
+ *
+ * Input of a gene is collected in a segment that is run-length encoded into
+ * a COO buffer of (element, gene, count) triples when the next gene starts.
+ * finalize() sorts the buffer by gene and element with two counting sorts and
+ * merges triples of genes that were entered more than once. Structure getters
+ * are valid only after finalize().
+ */
+class GeneCountMatrix : public IDataStructure {
+private:
+    const std::function<std::string (unsigned)> elementLabelGenerator;
+    const std::vector<std::string> geneLabels;
+    Rcpp::Function createGCS;
+    bool finalized;
+    unsigned currentGene;
+
+    std::vector<unsigned> segment;
+    std::vector<unsigned> cooElements, cooGenes, cooCounts;
+    std::vector<unsigned> elements, offsets, genes, counts;
+    std::unordered_map<unsigned, std::vector<int> > dummy;
+
+    void closeSegment();
+    void filterElements();
+
+public:
+    GeneCountMatrix(const std::function<std::string (unsigned)> elementLabelGenerator,
+                    const std::vector<std::string> & geneLabels,
+                    Rcpp::Function createGCS=Rcpp::Function("list"));
+
+    virtual void sGeneInput(unsigned gene);
+    virtual void sElementInput(unsigned element, int position);
+    virtual void finalize();
+
+    virtual const std::unordered_map<unsigned, std::vector<int> >& getStructure() const;
+    /// Sorted element IDs, one per column
+    const std::vector<unsigned>& getElements() const;
+    /// getElements().size()+1 offsets into getGenes() and getCounts()
+    const std::vector<unsigned>& getOffsets() const;
+    const std::vector<unsigned>& getGenes() const;
+    const std::vector<unsigned>& getCounts() const;
+    virtual SEXP getSEXP() const;
+
+    virtual unsigned getElementCount() const;
+    virtual unsigned getGeneCount() const;
+    virtual std::string getElementLabel(unsigned element) const;
+    virtual const std::string& getGeneLabel(unsigned gene) const;
+    virtual std::unordered_map<unsigned, std::string> getElementLabels() const;
+    virtual const std::vector<std::string> & getGeneLabels() const;
+    virtual ~GeneCountMatrix() {};
+};
+
+#endif /* GENECOUNTMATRIX_H_ */
@@ -0,0 +1,44 @@
+#include "GeneFilter.h"
+#include <algorithm>
+
+GeneFilter::GeneFilter(unsigned minGenes, unsigned maxGenes, unsigned topN) :
+    minGenes(minGenes),
+    maxGenes(maxGenes),
+    topN(topN)
+{}
+
+bool GeneFilter::isActive() const {
+    // Every stored element is found in at least one gene
+    return minGenes > 1 || maxGenes < std::numeric_limits<unsigned>::max() ||
+        topN < std::numeric_limits<unsigned>::max();
+}
+
+std::vector<unsigned> GeneFilter::rowCounts(const std::vector<unsigned>& offsets) {
+    std::vector<unsigned> counts(offsets.size() - 1);
+    for (unsigned i = 0; i + 1 < offsets.size(); i++) {
+        counts[i] = offsets[i + 1] - offsets[i];
+    }
+    return counts;
+}
+
+std::vector<bool> GeneFilter::select(const std::vector<unsigned>& ids,
+                                     const std::vector<unsigned>& support) const {
+    std::vector<bool> keep(ids.size(), false);
+    std::vector<unsigned> passed;
+    for (unsigned i = 0; i < ids.size(); i++) {
+        if (support[i] >= minGenes && support[i] <= maxGenes) {
+            passed.push_back(i);
+        }
+    }
+    if (passed.size() > topN) {
+        std::nth_element(passed.begin(), passed.begin() + topN, passed.end(),
+            [&ids, &support](unsigned a, unsigned b) {
+                return support[a] > support[b] || (support[a] == support[b] && ids[a] < ids[b]);
+            });
+        passed.resize(topN);
+    }
+    for (auto i : passed) {
+        keep[i] = true;
+    }
+    return keep;
+}
@@ -0,0 +1,64 @@
+#ifndef GENEFILTER_H_
+#define GENEFILTER_H_
+
+#include <algorithm>
+#include <vector>
+#include <limits>
+
+/**
+ * Gene support thresholds applied by data structures in finalize(), before
+ * any labels are generated: elements found in fewer than minGenes or more
+ * than maxGenes genes are dropped, then only topN elements with the largest
+ * support are kept (ties go to smaller element IDs).
+ */
+class GeneFilter {
+public:
+    unsigned minGenes, maxGenes, topN;
+
+    GeneFilter(unsigned minGenes = 1,
+               unsigned maxGenes = std::numeric_limits<unsigned>::max(),
+               unsigned topN = std::numeric_limits<unsigned>::max());
+
+    /// false if select() keeps every element
+    bool isActive() const;
+    /// Mask of kept elements given element IDs and their gene support
+    std::vector<bool> select(const std::vector<unsigned>& ids,
+                             const std::vector<unsigned>& support) const;
+    /**
+     * Applies select() to elements stored by offsets: element ids[i] owns
+     * rows [offsets[i], offsets[i+1]) of every column. Dropped elements and
+     * their rows are removed in place.
+     */
+    template<class... Columns>
+    void compact(std::vector<unsigned>& ids, std::vector<unsigned>& offsets,
+                 const std::vector<unsigned>& support, Columns&... columns) const;
+    /// Support of elements stored by offsets with one row per gene
+    static std::vector<unsigned> rowCounts(const std::vector<unsigned>& offsets);
+};
+
+template<class... Columns>
+void GeneFilter::compact(std::vector<unsigned>& ids, std::vector<unsigned>& offsets,
+                         const std::vector<unsigned>& support, Columns&... columns) const {
+    std::vector<bool> keep = select(ids, support);
+    // Kept rows only move to the left
+    unsigned kept = 0, begin = 0;
+    for (unsigned i = 0; i < ids.size(); i++) {
+        unsigned end = offsets[i + 1];
+        if (keep[i]) {
+            unsigned out = offsets[kept];
+            ids[kept] = ids[i];
+            int moved[] = {0, (std::copy(columns.begin() + begin, columns.begin() + end,
+                                         columns.begin() + out), 0)...};
+            (void)moved;
+            offsets[kept + 1] = out + end - begin;
+            kept++;
+        }
+        begin = end;
+    }
+    ids.resize(kept);
+    offsets.resize(kept + 1);
+    int resized[] = {0, (columns.resize(offsets.back()), 0)...};
+    (void)resized;
+}
+
+#endif /* GENEFILTER_H_ */
@@ -6,12 +6,29 @@
 #include <string>
 #include <unordered_map>
 #include <functional>
+#include "GeneFilter.h"
 
 class IDataStructure {
+protected:
+    GeneFilter geneFilter;
+    size_t memoryBudget = 0;
 
 public:
+    /// Must be set before finalize(), ignored by structures without genes
+    void setGeneFilter(const GeneFilter& filter) { geneFilter = filter; }
+    const GeneFilter& getGeneFilter() const { return geneFilter; }
+    /**
+     * Approximate limit in bytes for data kept in memory during the scan,
+     * 0 for no limit. Structures that support it spill to temporary files
+     * above the limit and merge them back in finalize(). The merged result
+     * is held in memory in full, so the limit bounds only the scan.
+     */
+    void setMemoryBudget(size_t bytes) { memoryBudget = bytes; }
+
     virtual void sGeneInput(unsigned gene) = 0;
     virtual void sElementInput(unsigned element, int position) = 0;
+    /// Called once after the last input, before the structure is read
+    virtual void finalize() {};
 
     virtual const std::unordered_map<unsigned, std::vector<int> >& getStructure() const = 0;
     virtual SEXP getSEXP() const = 0;
@@ -0,0 +1,98 @@
+#include "MappedIntegers.h"
+#include <Rversion.h>
+#include <algorithm>
+
+#ifdef R_VERSION
+#if R_VERSION >= R_Version(3, 6, 0)
+#include <R_ext/Altrep.h>
+#define MAPPED_INTEGERS_ALTREP
+#endif
+#endif
+
+#ifdef MAPPED_INTEGERS_ALTREP
+
+/*
+ * data1 is an external pointer to the Mapping, data2 is unused.
+ */
+namespace {
+
+struct Mapping {
+    std::shared_ptr<const void> owner;
+    int * data;
+    R_xlen_t length;
+};
+
+R_altrep_class_t mappedClass;
+
+Mapping * getMapping(SEXP x) {
+    return static_cast<Mapping *>(R_ExternalPtrAddr(R_altrep_data1(x)));
+}
+
+void finalizeMapping(SEXP ptr) {
+    delete static_cast<Mapping *>(R_ExternalPtrAddr(ptr));
+    R_ClearExternalPtr(ptr);
+}
+
+R_xlen_t mappedLength(SEXP x) {
+    return getMapping(x)->length;
+}
+
+int mappedElt(SEXP x, R_xlen_t i) {
+    return getMapping(x)->data[i];
+}
+
+R_xlen_t mappedGetRegion(SEXP x, R_xlen_t start, R_xlen_t size, int * out) {
+    Mapping * mapping = getMapping(x);
+    R_xlen_t count = std::min(size, mapping->length - start);
+    std::copy(mapping->data + start, mapping->data + start + count, out);
+    return count;
+}
+
+void * mappedDataptr(SEXP x, Rboolean writeable) {
+    return getMapping(x)->data;
+}
+
+const void * mappedDataptrOrNull(SEXP x) {
+    return getMapping(x)->data;
+}
+
+Rboolean mappedInspect(SEXP x, int pre, int deep, int pvec,
+                       void (*inspect_subtree)(SEXP, int, int, int)) {
+    Rprintf("mapped integers (%d)\n", (int)mappedLength(x));
+    return TRUE;
+}
+
+void initMappedClass() {
+    static bool initialized = false;
+    if (initialized) {
+        return;
+    }
+    mappedClass = R_make_altinteger_class("mapped_integers", "metaRE", NULL);
+    R_set_altrep_Length_method(mappedClass, mappedLength);
+    R_set_altrep_Inspect_method(mappedClass, mappedInspect);
+    R_set_altvec_Dataptr_method(mappedClass, mappedDataptr);
+    R_set_altvec_Dataptr_or_null_method(mappedClass, mappedDataptrOrNull);
+    R_set_altinteger_Elt_method(mappedClass, mappedElt);
+    R_set_altinteger_Get_region_method(mappedClass, mappedGetRegion);
+    initialized = true;
+}
+
+}
+
+SEXP makeMappedIntegers(const std::shared_ptr<const void>& owner, int * data, size_t length) {
+    initMappedClass();
+    SEXP ptr = PROTECT(R_MakeExternalPtr(new Mapping({owner, data, (R_xlen_t)length}),
+                                         R_NilValue, R_NilValue));
+    R_RegisterCFinalizerEx(ptr, finalizeMapping, TRUE);
+    SEXP result = R_new_altrep(mappedClass, ptr, R_NilValue);
+    UNPROTECT(1);
+    return result;
+}
+
+#else
+
+SEXP makeMappedIntegers(const std::shared_ptr<const void>&, int * data, size_t length) {
+    return Rcpp::IntegerVector(data, data + length);
+}
+
+#endif
@@ -0,0 +1,17 @@
+#ifndef MAPPEDINTEGERS_H_
+#define MAPPEDINTEGERS_H_
+
+#include <Rcpp.h>
+#include <memory>
+
+/**
+ * Integer vector over length ints at data, which stay valid while owner
+ * is alive.
+ *
+ * With R >= 3.6 this is an ALTREP vector that uses the memory in place and
+ * keeps owner alive until the vector is garbage collected. Older R versions
+ * get a copy.
+ */
+SEXP makeMappedIntegers(const std::shared_ptr<const void>& owner, int * data, size_t length);
+
+#endif /* MAPPEDINTEGERS_H_ */
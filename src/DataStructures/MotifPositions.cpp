@@ -1,10 +1,15 @@
 #include "MotifPositions.h"
+#include "ElementLabels.h"
+#include <algorithm>
+#include <numeric>
 
 MotifPositions::MotifPositions(const std::function<std::string (unsigned)> elementLabelGenerator,
                                const std::vector<std::string>& geneLabels) :
     elementLabelGenerator(elementLabelGenerator),
     geneLabels(geneLabels),
-    curGene(0)
+    curGene(0),
+    finalized(false),
+    elementOffsets({0})
 {}
 
 void MotifPositions::sGeneInput(unsigned gene) {
@@ -12,18 +17,65 @@ void MotifPositions::sGeneInput(unsigned gene) {
 }
 
 void MotifPositions::sElementInput(unsigned element, int position) {
-    auto it = data[element].find(curGene);
-    if (it != data[element].end()) {
-        (it->second).push_back(position);
-    } else {
-        data[element].insert(
-            std::pair<int, std::vector<int> >(curGene, std::vector<int>({position}))
-        );
+    elements.push_back(element);
+    genes.push_back(curGene);
+    positions.push_back(position);
+}
+
+template<class T>
+static void permute(std::vector<T>& column, const std::vector<unsigned>& order) {
+    std::vector<T> result(column.size());
+    for (unsigned i = 0; i < order.size(); i++) {
+        result[i] = column[order[i]];
+    }
+    column.swap(result);
+}
+
+void MotifPositions::finalize() {
+    if (finalized) {
+        return;
+    }
+    finalized = true;
+
+    std::vector<unsigned> order(elements.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](unsigned a, unsigned b) {
+        return elements[a] < elements[b] || (elements[a] == elements[b] && genes[a] < genes[b]);
+    });
+    permute(elements, order);
+    permute(genes, order);
+    permute(positions, order);
+
+    for (unsigned i = 1; i < elements.size(); i++) {
+        if (elements[i] != elements[i-1]) {
+            elementOffsets.push_back(i);
+        }
     }
+    if (!elements.empty()) {
+        elementOffsets.push_back(elements.size());
+    }
+    filterElements();
+}
+
+void MotifPositions::filterElements() {
+    if (!geneFilter.isActive()) {
+        return;
+    }
+    unsigned elementCount = elementOffsets.size() - 1;
+    std::vector<unsigned> ids(elementCount), support(elementCount, 0);
+    for (unsigned i = 0; i < elementCount; i++) {
+        ids[i] = elements[elementOffsets[i]];
+        for (unsigned j = elementOffsets[i]; j < elementOffsets[i + 1]; j++) {
+            if (j == elementOffsets[i] || genes[j] != genes[j - 1]) {
+                support[i]++;
+            }
+        }
+    }
+    geneFilter.compact(ids, elementOffsets, support, elements, genes, positions);
 }
 
 unsigned MotifPositions::getElementCount() const{
-    return data.size();
+    return elementOffsets.size() - 1;
 }
 
 unsigned MotifPositions::getGeneCount() const{
@@ -36,8 +88,9 @@ std::string MotifPositions::getElementLabel(unsigned element) const{
 
 std::unordered_map<unsigned, std::string> MotifPositions::getElementLabels() const {
     std::unordered_map<unsigned, std::string> result;
-    for (auto it : data) {
-        result[it.first] = getElementLabel(it.first);
+    for (unsigned i = 0; i + 1 < elementOffsets.size(); i++) {
+        unsigned element = elements[elementOffsets[i]];
+        result[element] = getElementLabel(element);
     }
     return result;
 }
@@ -55,21 +108,54 @@ const std::unordered_map<unsigned, std::vector<int> >& MotifPositions::getStruct
     return dummy;
 }
 
-const std::unordered_map<unsigned, std::unordered_map<int, std::vector<int> > >& MotifPositions::getPositions() const {
-    return data;
+const std::vector<unsigned>& MotifPositions::getElements() const {
+    return elements;
 }
 
-SEXP MotifPositions::getSEXP() const {
-    Rcpp::List result;
+const std::vector<unsigned>& MotifPositions::getGenes() const {
+    return genes;
+}
 
-    for (auto it : data) {
-        Rcpp::List sublist;
-        for (auto it2 : it.second) {
-            sublist[geneLabels[it2.first]] = Rcpp::wrap(it2.second);
+const std::vector<int>& MotifPositions::getPositions() const {
+    return positions;
+}
+
+const std::vector<unsigned>& MotifPositions::getElementOffsets() const {
+    return elementOffsets;
+}
+
+SEXP MotifPositions::getSEXP() const {
+    // Lists are allocated at their final size, gene runs of an element are
+    // counted before its sublist is filled
+    unsigned elementCount = getElementCount();
+    Rcpp::List result(elementCount);
+    std::vector<unsigned> ids(elementCount);
+    for (unsigned i = 0; i < elementCount; i++) {
+        unsigned begin = elementOffsets[i], end = elementOffsets[i+1];
+        unsigned runs = 0;
+        for (unsigned j = begin; j < end; j++) {
+            if (j == begin || genes[j] != genes[j-1]) {
+                runs++;
+            }
+        }
+        Rcpp::List sublist(runs);
+        Rcpp::CharacterVector names(runs);
+        unsigned run = 0, first = begin;
+        while (first < end) {
+            unsigned last = first;
+            while (last < end && genes[last] == genes[first]) {
+                last++;
+            }
+            sublist[run] = Rcpp::IntegerVector(positions.begin() + first, positions.begin() + last);
+            names[run] = geneLabels[genes[first]];
+            run++;
+            first = last;
         }
-        std::string element = elementLabelGenerator(it.first);
-        result[element] = sublist;
+        sublist.attr("names") = names;
+        result[i] = sublist;
+        ids[i] = elements[begin];
     }
+    result.attr("names") = makeElementLabels(ids, elementLabelGenerator);
     result.attr("genes") = geneLabels;
     return result;
 }
@@ -6,24 +6,44 @@
 #include <map>
 #include <string>
 
+/**
+ * Hits are stored as (element, gene, position) triples in three flat
+ * columns in scan order. finalize() sorts them by element and gene, keeping
+ * positions in scan order, so all hits of i-th element are in
+ * [getElementOffsets()[i], getElementOffsets()[i+1]).
+ * Structure getters are valid only after finalize().
+ *
+ * The memory budget is ignored: the columns already hold every hit once and
+ * the result needs all of them, so spilling could not lower the peak.
+ */
 class MotifPositions : public IDataStructure {
 private:
-    const std::vector<std::string> geneLabels;
     const std::function<std::string (unsigned)> elementLabelGenerator;
+    const std::vector<std::string> geneLabels;
     unsigned curGene;
+    bool finalized;
 
-    std::unordered_map<unsigned, std::unordered_map<int, std::vector<int> > > data;
+    std::vector<unsigned> elements, genes;
+    std::vector<int> positions;
+    std::vector<unsigned> elementOffsets;
     std::unordered_map<unsigned, std::vector<int> > dummy;
 
+    void filterElements();
+
 public:
     MotifPositions(const std::function<std::string (unsigned)> elementLabelGenerator,
                    const std::vector<std::string> & geneLabels);
 
     virtual void sGeneInput(unsigned gene);
     virtual void sElementInput(unsigned element, int position);
+    virtual void finalize();
 
     virtual const std::unordered_map<unsigned, std::vector<int> >& getStructure() const;
-    virtual const std::unordered_map<unsigned, std::unordered_map<int, std::vector<int> > >& getPositions() const;
+    const std::vector<unsigned>& getElements() const;
+    const std::vector<unsigned>& getGenes() const;
+    const std::vector<int>& getPositions() const;
+    /// Offsets of distinct elements in the columns, one more than getElementCount()
+    const std::vector<unsigned>& getElementOffsets() const;
     virtual SEXP getSEXP() const;
 
     virtual unsigned getElementCount() const;
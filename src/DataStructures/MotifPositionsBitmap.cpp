@@ -0,0 +1,87 @@
+#include "MotifPositionsBitmap.h"
+#include "ElementLabels.h"
+
+MotifPositionsBitmap::MotifPositionsBitmap(const std::function<std::string (unsigned)> elementLabelGenerator,
+                                           const std::vector<std::string>& geneLabels, Rcpp::Function createGCS) :
+    elementLabelGenerator(elementLabelGenerator),
+    geneLabels(geneLabels),
+    curGene(0),
+    createGCS(createGCS)
+{}
+
+void MotifPositionsBitmap::sGeneInput(unsigned gene) {
+    curGene = gene;
+}
+
+void MotifPositionsBitmap::sElementInput(unsigned element, int position) {
+    data[element].add(curGene);
+}
+
+void MotifPositionsBitmap::finalize() {
+    if (geneFilter.isActive()) {
+        std::vector<unsigned> ids, support;
+        for (const auto& it : data) {
+            ids.push_back(it.first);
+            support.push_back(it.second.cardinality());
+        }
+        std::vector<bool> keep = geneFilter.select(ids, support);
+        for (unsigned i = 0; i < ids.size(); i++) {
+            if (!keep[i]) {
+                data.erase(ids[i]);
+            }
+        }
+    }
+    for (auto& it : data) {
+        it.second.runOptimize();
+    }
+}
+
+unsigned MotifPositionsBitmap::getElementCount() const{
+    return data.size();
+}
+
+unsigned MotifPositionsBitmap::getGeneCount() const{
+    return geneLabels.size();
+}
+
+std::string MotifPositionsBitmap::getElementLabel(unsigned element) const{
+    return elementLabelGenerator(element);
+}
+
+std::unordered_map<unsigned, std::string> MotifPositionsBitmap::getElementLabels() const {
+    std::unordered_map<unsigned, std::string> result;
+    for (const auto& it : data) {
+        result[it.first] = getElementLabel(it.first);
+    }
+    return result;
+}
+
+const std::string& MotifPositionsBitmap::getGeneLabel(unsigned gene) const{
+    return geneLabels[gene];
+}
+
+const std::vector<std::string>& MotifPositionsBitmap::getGeneLabels() const{
+    return geneLabels;
+}
+
+const std::unordered_map<unsigned, std::vector<int> >& MotifPositionsBitmap::getStructure() const {
+    return dummy;
+}
+
+const std::unordered_map<unsigned, GeneBitmap>& MotifPositionsBitmap::getBitmaps() const {
+    return data;
+}
+
+SEXP MotifPositionsBitmap::getSEXP() const {
+    Rcpp::List result(data.size());
+    std::vector<unsigned> ids(data.size());
+    unsigned i = 0;
+    for (const auto& it : data) {
+        std::vector<uint8_t> bytes = it.second.serialize();
+        result[i] = Rcpp::RawVector(bytes.begin(), bytes.end());
+        ids[i] = it.first;
+        i++;
+    }
+    result.attr("names") = makeElementLabels(ids, elementLabelGenerator);
+    return createGCS(result, Rcpp::wrap(geneLabels));
+}
@@ -0,0 +1,48 @@
+#ifndef MOTIFPOSITIONSBITMAP_H_
+#define MOTIFPOSITIONSBITMAP_H_
+
+#include "IDataStructure.h"
+#include "GeneBitmap.h"
+#include <Rcpp.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+ * Set of genes for each element as a compressed GeneBitmap. Unlike
+ * MotifPositionsSparse every gene is listed once. Bitmaps are passed to R
+ * serialized into raw vectors.
+ */
+class MotifPositionsBitmap : public IDataStructure {
+private:
+    const std::function<std::string (unsigned)> elementLabelGenerator;
+    const std::vector<std::string> geneLabels;
+    unsigned curGene;
+    Rcpp::Function createGCS;
+
+    std::unordered_map<unsigned, GeneBitmap> data;
+    std::unordered_map<unsigned, std::vector<int> > dummy;
+
+public:
+    MotifPositionsBitmap(const std::function<std::string (unsigned)> elementLabelGenerator,
+                         const std::vector<std::string> & geneLabels,
+                         Rcpp::Function createGCS=Rcpp::Function("list"));
+
+    virtual void sGeneInput(unsigned gene);
+    virtual void sElementInput(unsigned element, int position);
+    virtual void finalize();
+
+    virtual const std::unordered_map<unsigned, std::vector<int> >& getStructure() const;
+    const std::unordered_map<unsigned, GeneBitmap>& getBitmaps() const;
+    virtual SEXP getSEXP() const;
+
+    virtual unsigned getElementCount() const;
+    virtual unsigned getGeneCount() const;
+    virtual std::string getElementLabel(unsigned element) const;
+    virtual const std::string& getGeneLabel(unsigned gene) const;
+    virtual std::unordered_map<unsigned, std::string> getElementLabels() const;
+    virtual const std::vector<std::string> & getGeneLabels() const;
+    virtual ~MotifPositionsBitmap() {};
+};
+
+#endif /* MOTIFPOSITIONSBITMAP_H_ */
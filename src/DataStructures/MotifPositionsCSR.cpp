@@ -0,0 +1,137 @@
+#include "MotifPositionsCSR.h"
+#include "ElementRanks.h"
+#include "ElementLabels.h"
+#include <algorithm>
+#include <limits>
+
+MotifPositionsCSR::MotifPositionsCSR(const std::function<std::string (unsigned)> elementLabelGenerator,
+                                     const std::vector<std::string>& geneLabels, Rcpp::Function createGCS) :
+    elementLabelGenerator(elementLabelGenerator),
+    geneLabels(geneLabels),
+    createGCS(createGCS),
+    finalized(false),
+    segmentGenes({0}),
+    segmentOffsets({0})
+{}
+
+void MotifPositionsCSR::closeSegment() {
+    auto first = segmentElements.begin() + segmentOffsets.back();
+    std::sort(first, segmentElements.end());
+    segmentElements.erase(std::unique(first, segmentElements.end()), segmentElements.end());
+    segmentOffsets.push_back(segmentElements.size());
+}
+
+void MotifPositionsCSR::sGeneInput(unsigned gene) {
+    closeSegment();
+    segmentGenes.push_back(gene);
+}
+
+void MotifPositionsCSR::sElementInput(unsigned element, int position) {
+    segmentElements.push_back(element);
+}
+
+void MotifPositionsCSR::finalize() {
+    if (finalized) {
+        return;
+    }
+    finalized = true;
+    closeSegment();
+    elements = rankIds(segmentElements);
+
+    // Counting sort of (element, gene) pairs by element, keeping segment order.
+    // A gene is skipped if it is already the last one of the element,
+    // same as in MotifPositionsSparse.
+    const unsigned none = std::numeric_limits<unsigned>::max();
+    std::vector<unsigned> lastGene(elements.size(), none);
+    offsets.assign(elements.size() + 1, 0);
+    for (unsigned s = 0; s < segmentGenes.size(); s++) {
+        for (unsigned i = segmentOffsets[s]; i < segmentOffsets[s+1]; i++) {
+            unsigned element = segmentElements[i];
+            if (lastGene[element] != segmentGenes[s]) {
+                lastGene[element] = segmentGenes[s];
+                offsets[element + 1]++;
+            }
+        }
+    }
+    for (unsigned i = 0; i < elements.size(); i++) {
+        offsets[i + 1] += offsets[i];
+    }
+
+    genes.resize(offsets.back());
+    std::vector<unsigned> next(offsets.begin(), offsets.end() - 1);
+    std::fill(lastGene.begin(), lastGene.end(), none);
+    for (unsigned s = 0; s < segmentGenes.size(); s++) {
+        for (unsigned i = segmentOffsets[s]; i < segmentOffsets[s+1]; i++) {
+            unsigned element = segmentElements[i];
+            if (lastGene[element] != segmentGenes[s]) {
+                lastGene[element] = segmentGenes[s];
+                genes[next[element]++] = segmentGenes[s];
+            }
+        }
+    }
+
+    std::vector<unsigned>().swap(segmentGenes);
+    std::vector<unsigned>().swap(segmentOffsets);
+    std::vector<unsigned>().swap(segmentElements);
+    filterElements();
+}
+
+void MotifPositionsCSR::filterElements() {
+    if (!geneFilter.isActive()) {
+        return;
+    }
+    geneFilter.compact(elements, offsets, GeneFilter::rowCounts(offsets), genes);
+}
+
+unsigned MotifPositionsCSR::getElementCount() const{
+    return elements.size();
+}
+
+unsigned MotifPositionsCSR::getGeneCount() const{
+    return geneLabels.size();
+}
+
+std::string MotifPositionsCSR::getElementLabel(unsigned element) const{
+    return elementLabelGenerator(element);
+}
+
+std::unordered_map<unsigned, std::string> MotifPositionsCSR::getElementLabels() const {
+    std::unordered_map<unsigned, std::string> result;
+    for (auto element : elements) {
+        result[element] = getElementLabel(element);
+    }
+    return result;
+}
+
+const std::string& MotifPositionsCSR::getGeneLabel(unsigned gene) const{
+    return geneLabels[gene];
+}
+
+const std::vector<std::string>& MotifPositionsCSR::getGeneLabels() const{
+    return geneLabels;
+}
+
+const std::unordered_map<unsigned, std::vector<int> >& MotifPositionsCSR::getStructure() const {
+    return dummy;
+}
+
+const std::vector<unsigned>& MotifPositionsCSR::getElements() const {
+    return elements;
+}
+
+const std::vector<unsigned>& MotifPositionsCSR::getOffsets() const {
+    return offsets;
+}
+
+const std::vector<unsigned>& MotifPositionsCSR::getGenes() const {
+    return genes;
+}
+
+SEXP MotifPositionsCSR::getSEXP() const {
+    Rcpp::RObject elementNames = makeElementLabels(elements, elementLabelGenerator);
+    Rcpp::IntegerVector rOffsets(offsets.begin(), offsets.end());
+    Rcpp::IntegerVector rGenes(genes.size());
+    std::transform(genes.begin(), genes.end(), rGenes.begin(), [](unsigned x){return x+1;});
+
+    return createGCS(rOffsets, rGenes, elementNames, Rcpp::wrap(geneLabels));
+}
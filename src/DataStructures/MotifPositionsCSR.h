@@ -0,0 +1,60 @@
+#ifndef MOTIFPOSITIONSCSR_H_
+#define MOTIFPOSITIONSCSR_H_
+
+#include "IDataStructure.h"
+#include <Rcpp.h>
+#include <vector>
+#include <string>
+#include <functional>
+
+/**
+ * Same information as MotifPositionsSparse stored in compressed sparse row
+ * form: genes of getElements()[i] are getGenes()[getOffsets()[i]..getOffsets()[i+1]).
+ *
+ * Input is appended to flat per-gene segments, each segment is sorted and
+ * deduplicated when the next gene starts, and finalize() transposes the
+ * segments with a counting sort. Structure getters are valid only after
+ * finalize().
+ */
+class MotifPositionsCSR : public IDataStructure {
+private:
+    const std::function<std::string (unsigned)> elementLabelGenerator;
+    const std::vector<std::string> geneLabels;
+    Rcpp::Function createGCS;
+    bool finalized;
+
+    // Elements of segment s are segmentElements[segmentOffsets[s]..segmentOffsets[s+1])
+    std::vector<unsigned> segmentGenes, segmentOffsets, segmentElements;
+    std::vector<unsigned> elements, offsets, genes;
+    std::unordered_map<unsigned, std::vector<int> > dummy;
+
+    void closeSegment();
+    void filterElements();
+
+public:
+    MotifPositionsCSR(const std::function<std::string (unsigned)> elementLabelGenerator,
+                      const std::vector<std::string> & geneLabels,
+                      Rcpp::Function createGCS=Rcpp::Function("list"));
+
+    virtual void sGeneInput(unsigned gene);
+    virtual void sElementInput(unsigned element, int position);
+    virtual void finalize();
+
+    virtual const std::unordered_map<unsigned, std::vector<int> >& getStructure() const;
+    /// Sorted element IDs
+    const std::vector<unsigned>& getElements() const;
+    /// getElements().size()+1 offsets into getGenes()
+    const std::vector<unsigned>& getOffsets() const;
+    const std::vector<unsigned>& getGenes() const;
+    virtual SEXP getSEXP() const;
+
+    virtual unsigned getElementCount() const;
+    virtual unsigned getGeneCount() const;
+    virtual std::string getElementLabel(unsigned element) const;
+    virtual const std::string& getGeneLabel(unsigned gene) const;
+    virtual std::unordered_map<unsigned, std::string> getElementLabels() const;
+    virtual const std::vector<std::string> & getGeneLabels() const;
+    virtual ~MotifPositionsCSR() {};
+};
+
+#endif /* MOTIFPOSITIONSCSR_H_ */
@@ -6,15 +6,21 @@
  */
 
 #include "MotifPositionsSparse.h"
+#include "ElementLabels.h"
+#include <algorithm>
 
 MotifPositionsSparse::MotifPositionsSparse(const std::function<std::string (unsigned)> elementLabelGenerator,
 										   const std::vector<std::string>& geneLabels, Rcpp::Function createGCS) :
 		elementLabelGenerator(elementLabelGenerator),
 		geneLabels(geneLabels),
 		curGene(0),
-		createGCS(createGCS)
+		createGCS(createGCS),
+		spilled(false),
+		pairs(0)
 {}
 
+const size_t MotifPositionsSparse::ENTRY_BYTES;
+
 void MotifPositionsSparse::sGeneInput(unsigned gene) {
 	curGene = gene;
 }
@@ -22,11 +28,93 @@ void MotifPositionsSparse::sGeneInput(unsigned gene) {
 void MotifPositionsSparse::sElementInput(unsigned element, int position) {
     if (data[element].empty() || data[element].back() != curGene) {
 	    data[element].push_back(curGene);
+	    pairs++;
+	    if (memoryBudget && data.size() * ENTRY_BYTES + pairs * sizeof(int) > memoryBudget) {
+	    	spill();
+	    }
     }
 }
 
+void MotifPositionsSparse::spill() {
+	std::vector<Record> batch;
+	batch.reserve(pairs);
+	for (const auto& it : data) {
+		for (int gene : it.second) {
+			batch.push_back(Record{it.first, (unsigned)gene});
+		}
+	}
+	std::unordered_map<unsigned, std::vector<int>>().swap(data);
+	pairs = 0;
+	runs.write(batch);
+	spilled = true;
+}
+
+void MotifPositionsSparse::finalize() {
+	if (spilled && !runs.empty()) {
+		spill();
+		mergedOffsets.assign(1, 0);
+		runs.merge([this](const Record& record) {
+			if (mergedElements.empty() || mergedElements.back() != record.element) {
+				mergedElements.push_back(record.element);
+				mergedOffsets.push_back(mergedOffsets.back());
+			} else if (mergedGenes.back() == record.gene) {
+				// Same gene on both sides of a spill
+				return;
+			}
+			mergedGenes.push_back(record.gene);
+			mergedOffsets.back()++;
+		});
+	}
+	if (!geneFilter.isActive()) {
+		return;
+	}
+	if (spilled) {
+		geneFilter.compact(mergedElements, mergedOffsets,
+		                   GeneFilter::rowCounts(mergedOffsets), mergedGenes);
+		return;
+	}
+	std::vector<unsigned> ids, support;
+	for (const auto& it : data) {
+		ids.push_back(it.first);
+		support.push_back(it.second.size());
+	}
+	std::vector<bool> keep = geneFilter.select(ids, support);
+	for (unsigned i = 0; i < ids.size(); i++) {
+		if (!keep[i]) {
+			data.erase(ids[i]);
+		}
+	}
+}
+
+bool MotifPositionsSparse::isSpilled() const {
+	return spilled;
+}
+
+const std::vector<unsigned>& MotifPositionsSparse::getMergedElements() const {
+	return mergedElements;
+}
+
+const std::vector<unsigned>& MotifPositionsSparse::getMergedOffsets() const {
+	return mergedOffsets;
+}
+
+const std::vector<unsigned>& MotifPositionsSparse::getMergedGenes() const {
+	return mergedGenes;
+}
+
 unsigned MotifPositionsSparse::getElementCount() const{
-	return data.size();
+	return spilled ? mergedElements.size() : data.size();
+}
+
+std::unordered_map<unsigned, std::string> MotifPositionsSparse::getElementLabels() const {
+	if (!spilled) {
+		return IDataStructure::getElementLabels();
+	}
+	std::unordered_map<unsigned, std::string> result;
+	for (auto element : mergedElements) {
+		result[element] = getElementLabel(element);
+	}
+	return result;
 }
 
 unsigned MotifPositionsSparse::getGeneCount() const{
@@ -50,19 +138,33 @@ const std::unordered_map<unsigned, std::vector<int>>& MotifPositionsSparse::getS
 }
 
 SEXP MotifPositionsSparse::getSEXP() const {
-    Rcpp::CharacterVector genes = Rcpp::wrap(geneLabels);
-
-    std::unordered_map<std::string, std::vector<int>> cppResult;
-    for (auto it : data) {
-        std::string elementName = elementLabelGenerator(it.first);
-        cppResult[elementName] = std::vector<int>(it.second.size());
-        std::transform(
-            it.second.begin(), it.second.end(),
-            cppResult[elementName].begin(),
-            [](int x){return x+1;}
-        );
+    // Gene vectors are written straight into R memory in one pass
+    if (spilled) {
+        Rcpp::List result(mergedElements.size());
+        for (unsigned i = 0; i < mergedElements.size(); i++) {
+            Rcpp::IntegerVector genes(mergedOffsets[i + 1] - mergedOffsets[i]);
+            int * out = genes.begin();
+            for (unsigned j = mergedOffsets[i]; j < mergedOffsets[i + 1]; j++) {
+                *out++ = mergedGenes[j] + 1;
+            }
+            result[i] = genes;
+        }
+        result.attr("names") = makeElementLabels(mergedElements, elementLabelGenerator);
+        return createGCS(result, Rcpp::wrap(geneLabels));
     }
-
-    Rcpp::List result = Rcpp::wrap(cppResult);
-    return createGCS(result, genes);
+    Rcpp::List result(data.size());
+    std::vector<unsigned> ids(data.size());
+    unsigned i = 0;
+    for (const auto& it : data) {
+        Rcpp::IntegerVector genes(it.second.size());
+        int * out = genes.begin();
+        for (int gene : it.second) {
+            *out++ = gene + 1;
+        }
+        result[i] = genes;
+        ids[i] = it.first;
+        i++;
+    }
+    result.attr("names") = makeElementLabels(ids, elementLabelGenerator);
+    return createGCS(result, Rcpp::wrap(geneLabels));
 }
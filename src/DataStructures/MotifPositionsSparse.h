@@ -9,19 +9,42 @@
 #define MOTIFPOSITIONSSPARSE_H_
 
 #include "IDataStructure.h"
+#include "SortedRuns.hpp"
 #include <Rcpp.h>
 #include <vector>
 #include <string>
 #include <functional>
 
+/**
+ * Genes of every element are kept in a hash map of vectors. When the map
+ * outgrows the memory budget it is spilled to disk as a sorted run of
+ * (element, gene) records and cleared; finalize() merges the runs into flat
+ * vectors: genes of getMergedElements()[i] are
+ * getMergedGenes()[getMergedOffsets()[i]..getMergedOffsets()[i+1]).
+ * After a spill getStructure() is empty. The budget bounds only the scan,
+ * the merged vectors hold every (element, gene) pair of the result.
+ */
 class MotifPositionsSparse : public IDataStructure {
 private:
+	struct Record {
+		unsigned element, gene;
+	};
+	struct ByElement {
+		bool operator()(const Record& a, const Record& b) const { return a.element < b.element; }
+	};
+
 	const std::vector<std::string> geneLabels;
     const std::function<std::string (unsigned)> elementLabelGenerator;
 	unsigned curGene;
 	Rcpp::Function createGCS;
+	bool spilled;
+	size_t pairs;
 
 	std::unordered_map<unsigned, std::vector<int>> data;
+	SortedRuns<Record, ByElement> runs;
+	std::vector<unsigned> mergedElements, mergedOffsets, mergedGenes;
+
+	void spill();
 
 public:
 	MotifPositionsSparse(const std::function<std::string (unsigned)> elementLabelGenerator,
@@ -30,14 +53,24 @@ public:
 
     virtual void sGeneInput(unsigned gene);
     virtual void sElementInput(unsigned element, int position);
+    virtual void finalize();
+
+	/// Rough memory use of a map entry without its genes, for the budget
+	static const size_t ENTRY_BYTES = 96;
 
 	virtual const std::unordered_map<unsigned, std::vector<int>>& getStructure() const;
+	bool isSpilled() const;
+	/// Sorted element IDs after a spill, valid after finalize()
+	const std::vector<unsigned>& getMergedElements() const;
+	const std::vector<unsigned>& getMergedOffsets() const;
+	const std::vector<unsigned>& getMergedGenes() const;
 	virtual SEXP getSEXP() const;
 
 	virtual unsigned getElementCount() const;
 	virtual unsigned getGeneCount() const;
 	virtual std::string getElementLabel(unsigned element) const;
 	virtual const std::string& getGeneLabel(unsigned gene) const;
+	virtual std::unordered_map<unsigned, std::string> getElementLabels() const;
 	virtual const std::vector<std::string> & getGeneLabels() const;
 	virtual ~MotifPositionsSparse() {};
 };
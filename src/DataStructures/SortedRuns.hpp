@@ -0,0 +1,157 @@
+#ifndef SORTEDRUNS_H_
+#define SORTEDRUNS_H_
+
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+#include <queue>
+#include <memory>
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Sorted runs of trivially copyable records kept in a temporary file, used by
+ * data structures to spill their contents when they outgrow the memory
+ * budget. write() stable-sorts a batch and appends it as a new run at the end
+ * of the file, merge() streams all runs in order with a k-way merge, reading
+ * every run in blocks from its offset. All runs share one file, so the number
+ * of open descriptors doesn't grow with the number of runs. Records equal by
+ * Less come out in the order they were written, earlier runs first, so scan
+ * order survives spilling.
+ */
+template<class Record, class Less>
+class SortedRuns {
+private:
+    static const size_t BLOCK = 4096;
+
+    struct FileCloser {
+        void operator()(FILE * file) const { fclose(file); }
+    };
+    typedef std::unique_ptr<FILE, FileCloser> File;
+
+    struct Run {
+        uint64_t offset;
+        size_t size;
+    };
+
+    static void seek(FILE * file, uint64_t offset) {
+#ifdef _WIN32
+        int failed = _fseeki64(file, offset, SEEK_SET);
+#else
+        int failed = fseeko(file, offset, SEEK_SET);
+#endif
+        if (failed) {
+            throw std::runtime_error("Cannot seek in a temporary file with spilled data");
+        }
+    }
+
+    struct Reader {
+        FILE * file;
+        uint64_t offset;
+        size_t left, pos;
+        std::vector<Record> block;
+
+        Reader(FILE * file, const Run& run) : file(file), offset(run.offset), left(run.size), pos(0) {
+            next();
+        }
+        const Record& top() const { return block[pos]; }
+        bool done() const { return pos == block.size(); }
+        void next() {
+            if (++pos < block.size()) {
+                return;
+            }
+            block.resize(std::min(BLOCK, left));
+            pos = 0;
+            if (block.empty()) {
+                return;
+            }
+            // Readers share the file, so every block seeks to its own run
+            seek(file, offset);
+            if (fread(block.data(), sizeof(Record), block.size(), file) != block.size()) {
+                throw std::runtime_error("Cannot read spilled data from a temporary file");
+            }
+            offset += block.size() * sizeof(Record);
+            left -= block.size();
+        }
+    };
+
+    File file;
+    uint64_t end = 0;
+    std::vector<Run> runs;
+    Less less;
+
+public:
+    SortedRuns() {}
+    SortedRuns(const SortedRuns&) = delete;
+    SortedRuns& operator=(const SortedRuns&) = delete;
+
+    /// Sorts batch in place and writes it as a new run
+    void write(std::vector<Record>& batch) {
+        std::stable_sort(batch.begin(), batch.end(), less);
+        if (!file) {
+            file.reset(std::tmpfile());
+            if (!file) {
+                throw std::runtime_error("Cannot create a temporary file for spilled data");
+            }
+        }
+        seek(file.get(), end);
+        if (fwrite(batch.data(), sizeof(Record), batch.size(), file.get()) != batch.size()) {
+            throw std::runtime_error("Cannot write spilled data to a temporary file");
+        }
+        runs.push_back(Run{end, batch.size()});
+        end += batch.size() * sizeof(Record);
+    }
+
+    bool empty() const { return runs.empty(); }
+    size_t count() const { return runs.size(); }
+
+    /// Total number of records in all runs
+    size_t size() const {
+        size_t result = 0;
+        for (const auto& run : runs) {
+            result += run.size;
+        }
+        return result;
+    }
+
+    /// Passes every record to consume(const Record&) in order and removes the runs
+    template<class Consumer>
+    void merge(Consumer consume) {
+        std::vector<Reader> readers;
+        readers.reserve(runs.size());
+        if (!runs.empty() && fflush(file.get()) != 0) {
+            throw std::runtime_error("Cannot write spilled data to a temporary file");
+        }
+        for (const auto& run : runs) {
+            readers.emplace_back(file.get(), run);
+        }
+        // Top of the queue is the smallest record, ties go to earlier runs
+        auto later = [this, &readers](unsigned a, unsigned b) {
+            return less(readers[b].top(), readers[a].top()) ||
+                (!less(readers[a].top(), readers[b].top()) && a > b);
+        };
+        std::priority_queue<unsigned, std::vector<unsigned>, decltype(later)> queue(later);
+        for (unsigned i = 0; i < readers.size(); i++) {
+            if (!readers[i].done()) {
+                queue.push(i);
+            }
+        }
+        while (!queue.empty()) {
+            unsigned i = queue.top();
+            queue.pop();
+            consume(readers[i].top());
+            readers[i].next();
+            if (!readers[i].done()) {
+                queue.push(i);
+            }
+        }
+        runs.clear();
+        file.reset();
+        end = 0;
+    }
+};
+
+template<class Record, class Less>
+const size_t SortedRuns<Record, Less>::BLOCK;
+
+#endif /* SORTEDRUNS_H_ */
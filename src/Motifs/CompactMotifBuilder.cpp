@@ -91,7 +91,9 @@ CompactMotif * CompactMotifBuilder::buildComplement(unsigned size) const {
 void CompactMotifBuilder::write(cell * buf, unsigned size) const {
     unsigned lastCell = (size-1) / COMPACTS_PER_CELL;
     memcpy(buf, this->buf, (lastCell+1)*sizeof(cell));
-    buf[lastCell] &= (1 << (size % COMPACTS_PER_CELL * COMPACT_SIZE)) - 1;
+    if (size % COMPACTS_PER_CELL) {
+        buf[lastCell] &= ((cell)1 << (size % COMPACTS_PER_CELL * COMPACT_SIZE)) - 1;
+    }
 }
 
 CompactMotifBuilder::~CompactMotifBuilder() {
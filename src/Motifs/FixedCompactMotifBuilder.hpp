@@ -0,0 +1,151 @@
+#ifndef FIXEDCOMPACTMOTIFBUILDER_H_
+#define FIXEDCOMPACTMOTIFBUILDER_H_
+
+#include "CompactMotif.h"
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+/**
+ * Same as CompactMotifBuilder, but the number of cells is a template
+ * parameter, so the buffers live inside the object and the shifting loops
+ * are unrolled by the compiler. With CELLS=1 (k <= 32) put() is a couple of
+ * shifts per nucleotide.
+ */
+template<unsigned CELLS>
+class FixedCompactMotifBuilder {
+private:
+    cell buf[CELLS], complement[CELLS];
+    unsigned length, accumulated, pos, topShift;
+
+    void fillComplementBuf(unsigned size, cell target[]) const;
+public:
+    FixedCompactMotifBuilder(unsigned size);
+
+    /// Shows if motif of given size is ready for output
+    bool ready(unsigned size) const;
+    bool ready() const { return ready(length); };
+
+    void skip();
+    void put(unsigned nucleotide);
+    void putIUPAC(unsigned nucleotide);
+    void clear();
+
+    CompactMotif * build(unsigned size) const;
+    CompactMotif * build() const { return build(length); };
+
+    CompactMotif * buildComplement(unsigned size) const;
+    CompactMotif * buildComplement() const { return buildComplement(length); };
+
+    void write(cell * buf, unsigned size) const;
+    void write(cell * buf) const { write(buf, length); };
+
+    unsigned getLength() const { return length; };
+    unsigned getPos() const { return pos; };
+};
+
+template<unsigned CELLS>
+FixedCompactMotifBuilder<CELLS>::FixedCompactMotifBuilder(unsigned size) :
+    length(size),
+    accumulated(0),
+    pos(0),
+    topShift((size - 1) % COMPACTS_PER_CELL * COMPACT_SIZE)
+{
+    static_assert(CELLS > 0, "FixedCompactMotifBuilder needs at least one cell");
+    if (size == 0 || (size - 1) / COMPACTS_PER_CELL + 1 != CELLS) {
+        throw std::invalid_argument("Motif length does not match builder cell count");
+    }
+    std::fill(buf, buf + CELLS, 0);
+    std::fill(complement, complement + CELLS, 0);
+}
+
+template<unsigned CELLS>
+bool FixedCompactMotifBuilder<CELLS>::ready(unsigned size) const {
+    return accumulated >= size && size <= length;
+}
+
+template<unsigned CELLS>
+void FixedCompactMotifBuilder<CELLS>::skip() {
+    accumulated = 0;
+    pos++;
+}
+
+template<unsigned CELLS>
+void FixedCompactMotifBuilder<CELLS>::put(unsigned nucleotide) {
+    cell carry = nucleotide & COMPACT_MASK;
+    for (unsigned i = 0; i < CELLS; i++) {
+        cell nextCarry = (buf[i] >> ((COMPACTS_PER_CELL-1) * COMPACT_SIZE)) & COMPACT_MASK;
+        buf[i] = (buf[i] << COMPACT_SIZE) | carry;
+        carry = nextCarry;
+    }
+    if (accumulated < length) {
+        putCompact(complement, accumulated, COMPACT_RC[nucleotide]);
+        accumulated++;
+    } else {
+        carry = ((cell)COMPACT_RC[nucleotide]) << topShift;
+        for (unsigned i = CELLS; i-- > 0; ) {
+            cell nextCarry = (complement[i] & COMPACT_MASK) << ((COMPACTS_PER_CELL-1) * COMPACT_SIZE);
+            complement[i] = (complement[i] >> COMPACT_SIZE) | carry;
+            carry = nextCarry;
+        }
+    }
+    pos++;
+}
+
+template<unsigned CELLS>
+void FixedCompactMotifBuilder<CELLS>::putIUPAC(unsigned nucleotide) {
+    if (IUPAC_TO_COMPACT[nucleotide] == -1) {
+        throw std::invalid_argument("Nucleotide is ambiguous");
+    }
+    put(IUPAC_TO_COMPACT[nucleotide]);
+}
+
+template<unsigned CELLS>
+void FixedCompactMotifBuilder<CELLS>::clear() {
+    accumulated = 0;
+    pos = 0;
+}
+
+template<unsigned CELLS>
+CompactMotif * FixedCompactMotifBuilder<CELLS>::build(unsigned size) const {
+    if (accumulated < size) {
+        throw std::out_of_range("Motif is longer than the accumulated sequence");
+    }
+    return new CompactMotif(const_cast<cell *>(buf), size);
+}
+
+template<unsigned CELLS>
+void FixedCompactMotifBuilder<CELLS>::fillComplementBuf(unsigned size, cell compBuf[]) const {
+    // Shift the complement by (accumulated-size)*COMPACT_SIZE bits right
+    const unsigned cellSize = sizeof(cell) * 8;
+    unsigned shift = (std::min(accumulated, length)-size)*COMPACT_SIZE;
+    unsigned bitShift = shift % cellSize;
+    unsigned arrayShift = shift / cellSize;
+    for (unsigned i = 0; i + arrayShift < CELLS; i++) {
+        compBuf[i] = complement[i+arrayShift] >> bitShift;
+        if (bitShift && i + arrayShift + 1 < CELLS) {
+            compBuf[i] |= complement[i+arrayShift+1] << (cellSize-bitShift);
+        }
+    }
+}
+
+template<unsigned CELLS>
+CompactMotif * FixedCompactMotifBuilder<CELLS>::buildComplement(unsigned size) const {
+    if (accumulated < size) {
+        throw std::out_of_range("Motif is longer than the accumulated sequence");
+    }
+    cell compBuf[CELLS] = {};
+    fillComplementBuf(size, compBuf);
+    return new CompactMotif(compBuf, size);
+}
+
+template<unsigned CELLS>
+void FixedCompactMotifBuilder<CELLS>::write(cell * buf, unsigned size) const {
+    unsigned lastCell = (size-1) / COMPACTS_PER_CELL;
+    std::memcpy(buf, this->buf, (lastCell+1)*sizeof(cell));
+    if (size % COMPACTS_PER_CELL) {
+        buf[lastCell] &= ((cell)1 << (size % COMPACTS_PER_CELL * COMPACT_SIZE)) - 1;
+    }
+}
+
+#endif /* FIXEDCOMPACTMOTIFBUILDER_H_ */
@@ -0,0 +1,158 @@
+#ifndef FIXEDIUPACMOTIFBUILDER_H_
+#define FIXEDIUPACMOTIFBUILDER_H_
+
+#include "IUPACMotif.h"
+#include <algorithm>
+#include <stdexcept>
+
+/**
+ * Same as IUPACMotifBuilder, but the number of cells is a template
+ * parameter, so the buffers live inside the object and the shifting loops
+ * are unrolled by the compiler. With CELLS=1 (k <= 16) put() is a couple of
+ * shifts per nucleotide.
+ */
+template<unsigned CELLS>
+class FixedIUPACMotifBuilder {
+private:
+    cell buf[CELLS], complement[CELLS];
+    unsigned length, accumulated, topShift;
+
+    void fillComplementBuf(unsigned size, cell target[]) const;
+public:
+    FixedIUPACMotifBuilder(unsigned size);
+
+    /// Shows if motif of given size is ready for output
+    bool ready(unsigned size) const;
+    bool ready() const { return ready(length); };
+
+    void skip();
+    void put(unsigned nucleotide);
+    void putCompact(unsigned nucleotide);
+    void clear();
+
+    IUPACMotif * build(unsigned size) const;
+    IUPACMotif * build() const { return build(length); };
+
+    IUPACMotif * buildComplement(unsigned size) const;
+    IUPACMotif * buildComplement() const { return buildComplement(length); };
+
+    bool matches(IUPACMotif &pattern, bool rc = false) const;
+    /// Both-strand match against a precomputed reverse complement of the pattern
+    bool matches(const IUPACMotif &pattern, const IUPACMotif &rcPattern) const;
+};
+
+template<unsigned CELLS>
+FixedIUPACMotifBuilder<CELLS>::FixedIUPACMotifBuilder(unsigned size) :
+    length(size),
+    accumulated(0),
+    topShift((size - 1) % IUPAC_PER_CELL * IUPAC_SIZE)
+{
+    static_assert(CELLS > 0, "FixedIUPACMotifBuilder needs at least one cell");
+    if (size == 0 || (size - 1) / IUPAC_PER_CELL + 1 != CELLS) {
+        throw std::invalid_argument("Motif length does not match builder cell count");
+    }
+    std::fill(buf, buf + CELLS, 0);
+    std::fill(complement, complement + CELLS, 0);
+}
+
+template<unsigned CELLS>
+bool FixedIUPACMotifBuilder<CELLS>::ready(unsigned size) const {
+    return accumulated >= size && size <= length;
+}
+
+template<unsigned CELLS>
+void FixedIUPACMotifBuilder<CELLS>::skip() {
+    accumulated = 0;
+}
+
+template<unsigned CELLS>
+void FixedIUPACMotifBuilder<CELLS>::put(unsigned nucleotide) {
+    cell carry = nucleotide & IUPAC_MASK;
+    for (unsigned i = 0; i < CELLS; i++) {
+        cell nextCarry = (buf[i] >> ((IUPAC_PER_CELL-1) * IUPAC_SIZE)) & IUPAC_MASK;
+        buf[i] = (buf[i] << IUPAC_SIZE) | carry;
+        carry = nextCarry;
+    }
+    if (accumulated < length) {
+        putIUPAC(complement, accumulated, IUPAC_RC[nucleotide]);
+        accumulated++;
+    } else {
+        carry = ((cell)IUPAC_RC[nucleotide]) << topShift;
+        for (unsigned i = CELLS; i-- > 0; ) {
+            cell nextCarry = (complement[i] & IUPAC_MASK) << ((IUPAC_PER_CELL-1) * IUPAC_SIZE);
+            complement[i] = (complement[i] >> IUPAC_SIZE) | carry;
+            carry = nextCarry;
+        }
+    }
+}
+
+template<unsigned CELLS>
+void FixedIUPACMotifBuilder<CELLS>::putCompact(unsigned nucleotide) {
+    put(COMPACT_TO_IUPAC[nucleotide]);
+}
+
+template<unsigned CELLS>
+void FixedIUPACMotifBuilder<CELLS>::clear() {
+    accumulated = 0;
+}
+
+template<unsigned CELLS>
+IUPACMotif * FixedIUPACMotifBuilder<CELLS>::build(unsigned size) const {
+    if (accumulated < size) {
+        throw std::out_of_range("Motif is longer than the accumulated sequence");
+    }
+    return new IUPACMotif(const_cast<cell *>(buf), size);
+}
+
+template<unsigned CELLS>
+void FixedIUPACMotifBuilder<CELLS>::fillComplementBuf(unsigned size, cell compBuf[]) const {
+    // Shift the complement by (accumulated-size)*IUPAC_SIZE bits right
+    const unsigned cellSize = sizeof(cell) * 8;
+    unsigned shift = (std::min(accumulated, length)-size)*IUPAC_SIZE;
+    unsigned bitShift = shift % cellSize;
+    unsigned arrayShift = shift / cellSize;
+    for (unsigned i = 0; i + arrayShift < CELLS; i++) {
+        compBuf[i] = complement[i+arrayShift] >> bitShift;
+        if (bitShift && i + arrayShift + 1 < CELLS) {
+            compBuf[i] |= complement[i+arrayShift+1] << (cellSize-bitShift);
+        }
+    }
+}
+
+template<unsigned CELLS>
+IUPACMotif * FixedIUPACMotifBuilder<CELLS>::buildComplement(unsigned size) const {
+    if (accumulated < size) {
+        throw std::out_of_range("Motif is longer than the accumulated sequence");
+    }
+    cell compBuf[CELLS] = {};
+    fillComplementBuf(size, compBuf);
+    return new IUPACMotif(compBuf, size);
+}
+
+template<unsigned CELLS>
+bool FixedIUPACMotifBuilder<CELLS>::matches(IUPACMotif &pattern, bool rc) const {
+    if (accumulated < pattern.getLength()) {
+        return false;
+    }
+    if (pattern.includes(const_cast<cell *>(buf), pattern.getLength())) {
+        return true;
+    }
+    if (rc) {
+        cell compBuf[CELLS] = {};
+        fillComplementBuf(pattern.getLength(), compBuf);
+        return pattern.includes(compBuf, pattern.getLength());
+    }
+    return false;
+}
+
+template<unsigned CELLS>
+bool FixedIUPACMotifBuilder<CELLS>::matches(const IUPACMotif &pattern, const IUPACMotif &rcPattern) const {
+    // rcPattern includes the window iff pattern includes its reverse complement
+    if (accumulated < pattern.getLength()) {
+        return false;
+    }
+    cell * window = const_cast<cell *>(buf);
+    return pattern.includes(window, pattern.getLength()) || rcPattern.includes(window, rcPattern.getLength());
+}
+
+#endif /* FIXEDIUPACMOTIFBUILDER_H_ */
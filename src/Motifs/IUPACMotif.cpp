@@ -1,4 +1,5 @@
 #include "IUPACMotif.h"
+#include "inclusion.h"
 #include <boost/algorithm/string.hpp>
 
 IUPACMotif::IUPACMotif(std::string sequence) :
@@ -125,24 +126,7 @@ bool IUPACMotif::includes(cell otherBuf[], unsigned length) const {
     if (this->length != length) {
         return false;
     }
-
-    bool result = true;
-    cell mask = 0x1111111111111111;
-    cell presentMask = 0xffffffffffffffff;
-    for (unsigned i = 0; i < bufSize && result; i++) {
-        if (i == bufSize-1 && length % IUPAC_PER_CELL != 0) {
-            presentMask = (1L << ((length % IUPAC_PER_CELL) * IUPAC_SIZE)) - 1L;
-            mask &= presentMask;
-        }
-
-        bool cond1 = (otherBuf[i] & ~buf[i] & presentMask) == 0;
-        cell X = otherBuf[i] & buf[i];
-        cell Y = (X | X >> 1 | X >> 2 | X >> 3);
-
-        bool cond2 = (Y & mask) == mask;
-        result &= cond1 && cond2;
-    }
-    return result;
+    return iupacIncludes(buf, otherBuf, length);
 }
 
 bool IUPACMotif::operator==(const Motif& motif) const {
@@ -61,13 +61,13 @@ void IUPACMotifBuilder::fillComplementBuf(unsigned size, cell compBuf[]) const {
     unsigned cellSize = (sizeof(cell) * 8);
     unsigned bitShift = shift % cellSize;
     unsigned arrayShift = shift / cellSize;
-    cell mask = (-1L) ^ ((1L << bitShift) - 1L);
-    for (int i = 0;  i < bufSize - arrayShift - 1;  ++i)
+    for (unsigned i = 0;  i + arrayShift < bufSize;  ++i)
     {
-        compBuf[i] = (complement[i+arrayShift] >> bitShift) |
-                     ((complement[i+arrayShift+1] << (cellSize-bitShift)) & mask);
+        compBuf[i] = complement[i+arrayShift] >> bitShift;
+        if (bitShift && i + arrayShift + 1 < bufSize) {
+            compBuf[i] |= complement[i+arrayShift+1] << (cellSize-bitShift);
+        }
     }
-    compBuf[bufSize - arrayShift - 1] = complement[bufSize - 1] >> bitShift;
 }
 
 IUPACMotif * IUPACMotifBuilder::buildComplement(unsigned size) const {
@@ -94,6 +94,14 @@ bool IUPACMotifBuilder::matches(IUPACMotif &pattern, bool rc) const {
     return pattern.includes(buf, pattern.getLength());
 }
 
+bool IUPACMotifBuilder::matches(const IUPACMotif &pattern, const IUPACMotif &rcPattern) const {
+    // rcPattern includes the window iff pattern includes its reverse complement
+    if (accumulated < pattern.getLength()) {
+        return false;
+    }
+    return pattern.includes(buf, pattern.getLength()) || rcPattern.includes(buf, rcPattern.getLength());
+}
+
 IUPACMotifBuilder::~IUPACMotifBuilder() {
     delete buf;
     delete complement;
@@ -28,6 +28,8 @@ public:
     IUPACMotif * buildComplement() const { return buildComplement(length); };
 
     bool matches(IUPACMotif &pattern, bool rc = false) const;
+    /// Both-strand match against a precomputed reverse complement of the pattern
+    bool matches(const IUPACMotif &pattern, const IUPACMotif &rcPattern) const;
 
     virtual ~IUPACMotifBuilder();
 };
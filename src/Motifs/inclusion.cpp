@@ -0,0 +1,113 @@
+#include "inclusion.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define INCLUSION_X86 1
+#include <immintrin.h>
+#endif
+
+bool includesScalar(const cell pattern[], const cell other[], unsigned length) {
+    unsigned cells = (length - 1) / IUPAC_PER_CELL + 1;
+    cell violations = 0;
+    for (unsigned i = 0; i + 1 < cells; i++) {
+        violations |= inclusionViolations(pattern[i], other[i], ~(cell)0);
+    }
+    violations |= inclusionViolations(pattern[cells-1], other[cells-1], inclusionTailMask(length));
+    return violations == 0;
+}
+
+#ifdef INCLUSION_X86
+
+__attribute__((target("sse2")))
+bool includesSSE2(const cell pattern[], const cell other[], unsigned length) {
+    const unsigned step = sizeof(__m128i) / sizeof(cell);
+    unsigned full = length / IUPAC_PER_CELL;
+    const __m128i mask = _mm_set1_epi64x(0x1111111111111111);
+    __m128i violations = _mm_setzero_si128();
+    unsigned i = 0;
+    for (; i + step <= full; i += step) {
+        __m128i p = _mm_loadu_si128((const __m128i *)(pattern + i));
+        __m128i o = _mm_loadu_si128((const __m128i *)(other + i));
+        __m128i x = _mm_and_si128(o, p);
+        __m128i y = _mm_or_si128(
+            _mm_or_si128(x, _mm_srli_epi64(x, 1)),
+            _mm_or_si128(_mm_srli_epi64(x, 2), _mm_srli_epi64(x, 3))
+        );
+        violations = _mm_or_si128(violations, _mm_andnot_si128(p, o));
+        violations = _mm_or_si128(violations, _mm_xor_si128(_mm_and_si128(y, mask), mask));
+    }
+    __m128i zero = _mm_cmpeq_epi8(violations, _mm_setzero_si128());
+    if (_mm_movemask_epi8(zero) != 0xffff) {
+        return false;
+    }
+    if (i * IUPAC_PER_CELL == length) {
+        return true;
+    }
+    return includesScalar(pattern + i, other + i, length - i * IUPAC_PER_CELL);
+}
+
+__attribute__((target("avx2")))
+bool includesAVX2(const cell pattern[], const cell other[], unsigned length) {
+    const unsigned step = sizeof(__m256i) / sizeof(cell);
+    unsigned full = length / IUPAC_PER_CELL;
+    const __m256i mask = _mm256_set1_epi64x(0x1111111111111111);
+    __m256i violations = _mm256_setzero_si256();
+    unsigned i = 0;
+    for (; i + step <= full; i += step) {
+        __m256i p = _mm256_loadu_si256((const __m256i *)(pattern + i));
+        __m256i o = _mm256_loadu_si256((const __m256i *)(other + i));
+        __m256i x = _mm256_and_si256(o, p);
+        __m256i y = _mm256_or_si256(
+            _mm256_or_si256(x, _mm256_srli_epi64(x, 1)),
+            _mm256_or_si256(_mm256_srli_epi64(x, 2), _mm256_srli_epi64(x, 3))
+        );
+        violations = _mm256_or_si256(violations, _mm256_andnot_si256(p, o));
+        violations = _mm256_or_si256(violations, _mm256_xor_si256(_mm256_and_si256(y, mask), mask));
+    }
+    if (!_mm256_testz_si256(violations, violations)) {
+        return false;
+    }
+    if (i * IUPAC_PER_CELL == length) {
+        return true;
+    }
+    return includesSSE2(pattern + i, other + i, length - i * IUPAC_PER_CELL);
+}
+
+bool inclusionSSE2Supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("sse2");
+}
+
+bool inclusionAVX2Supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+}
+
+#else
+
+bool includesSSE2(const cell pattern[], const cell other[], unsigned length) {
+    return includesScalar(pattern, other, length);
+}
+
+bool includesAVX2(const cell pattern[], const cell other[], unsigned length) {
+    return includesScalar(pattern, other, length);
+}
+
+bool inclusionSSE2Supported() {
+    return false;
+}
+
+bool inclusionAVX2Supported() {
+    return false;
+}
+
+#endif
+
+InclusionKernel getInclusionKernel() {
+    if (inclusionAVX2Supported()) {
+        return &includesAVX2;
+    }
+    if (inclusionSSE2Supported()) {
+        return &includesSSE2;
+    }
+    return &includesScalar;
+}
@@ -0,0 +1,55 @@
+#ifndef INCLUSION_H_
+#define INCLUSION_H_
+
+#include <cstdint>
+#include <string>
+#include <exception>
+#include "encodings.h"
+
+/**
+ * Degenerate inclusion of IUPAC-encoded buffers: pattern includes other
+ * if every nucleotide of other is a subset of the corresponding pattern
+ * nucleotide and they share at least one base.
+ *
+ * All kernels take both buffers as IUPAC cells of a motif of the given
+ * length; nibbles above the length in the last cell are ignored.
+ * The vectorized kernels fall back to the scalar one for the last,
+ * partially filled cell.
+ */
+
+/// Nonzero if other is not included by pattern within the present nibbles
+inline cell inclusionViolations(cell pattern, cell other, cell present) {
+    const cell mask = (cell)0x1111111111111111 & present;
+    cell X = other & pattern;
+    cell Y = X | X >> 1 | X >> 2 | X >> 3;
+    return (other & ~pattern & present) | ((Y & mask) ^ mask);
+}
+
+/// Mask of the nibbles used in the last cell of a motif
+inline cell inclusionTailMask(unsigned length) {
+    unsigned tail = length % IUPAC_PER_CELL;
+    return tail ? ((cell)1 << (tail * IUPAC_SIZE)) - 1 : ~(cell)0;
+}
+
+typedef bool (*InclusionKernel)(const cell pattern[], const cell other[], unsigned length);
+
+bool includesScalar(const cell pattern[], const cell other[], unsigned length);
+bool includesSSE2(const cell pattern[], const cell other[], unsigned length);
+bool includesAVX2(const cell pattern[], const cell other[], unsigned length);
+
+/// Kernel availability on the running CPU
+bool inclusionSSE2Supported();
+bool inclusionAVX2Supported();
+
+/// Best kernel for the running CPU, selected once
+InclusionKernel getInclusionKernel();
+
+inline bool iupacIncludes(const cell pattern[], const cell other[], unsigned length) {
+    if (length <= IUPAC_PER_CELL) {
+        return !inclusionViolations(pattern[0], other[0], inclusionTailMask(length));
+    }
+    static const InclusionKernel kernel = getInclusionKernel();
+    return kernel(pattern, other, length);
+}
+
+#endif /* INCLUSION_H_ */
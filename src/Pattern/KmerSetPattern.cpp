@@ -0,0 +1,54 @@
+#include "KmerSetPattern.h"
+#include "Pattern.h"
+#include "PatternWrongSizeException.hpp"
+#include <algorithm>
+
+const unsigned KmerSetPattern::MAX_LENGTH;
+
+KmerSetPattern::KmerSetPattern(std::string pattern) {
+	add(pattern);
+}
+
+void KmerSetPattern::add(std::string pattern) {
+	if (pattern.empty() || pattern.length() > MAX_LENGTH) {
+		throw PatternWrongSizeException("Pattern length must be within 1.." +
+				std::to_string(MAX_LENGTH) + ": " + pattern);
+	}
+	std::vector<uint64_t> added = Pattern::expand(pattern);
+	std::vector<uint64_t>& set = kmers[pattern.length()];
+	// Both parts are sorted, so merging keeps the set sorted
+	size_t middle = set.size();
+	set.insert(set.end(), added.begin(), added.end());
+	std::inplace_merge(set.begin(), set.begin() + middle, set.end());
+	set.erase(std::unique(set.begin(), set.end()), set.end());
+}
+
+bool KmerSetPattern::check(uint64_t kmer, unsigned length) const {
+	auto set = kmers.find(length);
+	if (set == kmers.end()) {
+		return false;
+	}
+	return std::binary_search(set->second.begin(), set->second.end(), kmer);
+}
+
+const std::vector<uint64_t>& KmerSetPattern::getKmers(unsigned length) const {
+	static const std::vector<uint64_t> empty;
+	auto set = kmers.find(length);
+	return set == kmers.end() ? empty : set->second;
+}
+
+std::vector<unsigned> KmerSetPattern::getLengths() const {
+	std::vector<unsigned> lengths;
+	for (const auto& set : kmers) {
+		lengths.push_back(set.first);
+	}
+	return lengths;
+}
+
+size_t KmerSetPattern::size() const {
+	size_t result = 0;
+	for (const auto& set : kmers) {
+		result += set.second.size();
+	}
+	return result;
+}
@@ -0,0 +1,34 @@
+#ifndef PATTERN_KMERSETPATTERN_H_
+#define PATTERN_KMERSETPATTERN_H_
+
+#include <string>
+#include <map>
+#include <vector>
+#include <cstdint>
+
+/**
+ * Pattern stored as sorted sets of unambigious kmers, one set per length.
+ * Unlike Pattern it accepts patterns of different lengths up to 32 letters,
+ * takes memory proportional to the number of expanded kmers and lists them
+ * without scanning the whole 4^k space. check() is a binary search.
+ */
+class KmerSetPattern {
+private:
+	std::map<unsigned, std::vector<uint64_t> > kmers;
+public:
+	static const unsigned MAX_LENGTH = 32;
+
+	KmerSetPattern() {};
+	KmerSetPattern(std::string pattern);
+	void add(std::string pattern);
+	bool check(uint64_t kmer, unsigned length) const;
+	/// Sorted kmers of the given length
+	const std::vector<uint64_t>& getKmers(unsigned length) const;
+	/// Lengths of the added patterns in increasing order
+	std::vector<unsigned> getLengths() const;
+	/// Number of distinct kmers over all lengths
+	size_t size() const;
+	virtual ~KmerSetPattern() {};
+};
+
+#endif /* PATTERN_KMERSETPATTERN_H_ */
@@ -11,6 +11,9 @@
 
 using namespace std;
 
+const unsigned Pattern::MAX_LENGTH;
+const unsigned Pattern::MASK_MAX_LENGTH;
+
 const map<char, const vector<unsigned> > Pattern::lettersToInt = {
 		{'a', {0}},
 		{'c', {1}},
@@ -40,19 +43,6 @@ Pattern::Pattern(std::string pattern) :
 	init(pattern);
 }
 
-void Pattern::recursiveAdd(unsigned start, string end) {
-	for (auto iter = lettersToInt.at(end[0]).begin();
-			iter != lettersToInt.at(end[0]).end();
-			iter++) {
-		unsigned next = start * 4 + *iter;
-		if (end.length() == 1) {
-			markPattern(next);
-		} else {
-			recursiveAdd(next, end.substr(1));
-		}
-	}
-}
-
 void Pattern::add(std::string pattern) {
 	if (maskSize == 0) {
 		init(pattern);
@@ -60,12 +50,20 @@ void Pattern::add(std::string pattern) {
 		if (pattern.length() != patternSize) {
 			throw PatternWrongSizeException("Attempt to add kmer to pattern of different size");
 		}
-		transform(pattern.begin(), pattern.end(), pattern.begin(), ::tolower);
-		recursiveAdd(0, pattern);
+		if (patternSize > MASK_MAX_LENGTH) {
+			kmerSet.add(pattern);
+			return;
+		}
+		for (uint64_t kmer : expand(pattern)) {
+			markPattern(kmer);
+		}
 	}
 }
 
 bool Pattern::check(unsigned kmer) const {
+	if (patternSize > MASK_MAX_LENGTH) {
+		return kmerSet.check(kmer, patternSize);
+	}
 	if ((kmer >> MASK_SHIFT) >= maskSize) {
 		return false;
 	}
@@ -79,19 +77,49 @@ void Pattern::markPattern(unsigned kmer) {
 }
 
 void Pattern::init(std::string pattern) {
+	if (pattern.empty() || pattern.length() > MAX_LENGTH) {
+		throw PatternWrongSizeException("Pattern length must be within 1.." +
+				to_string(MAX_LENGTH));
+	}
 	patternSize = pattern.length();
-	maskSize = 1 << (2*patternSize - MASK_SHIFT);
-
-	mask.resize(maskSize, 0);
+	if (patternSize > MASK_MAX_LENGTH) {
+		// Only marks the pattern as initialized, the mask isn't allocated
+		maskSize = 1;
+	} else {
+		// Patterns shorter than 3 letters still need one int64
+		maskSize = 2*patternSize > MASK_SHIFT ? 1ul << (2*patternSize - MASK_SHIFT) : 1;
+		mask.resize(maskSize, 0);
+	}
 	add(pattern);
 }
 
 std::vector<unsigned> Pattern::getKmers() const {
+	if (patternSize > MASK_MAX_LENGTH) {
+		const std::vector<uint64_t>& kmers = kmerSet.getKmers(patternSize);
+		return std::vector<unsigned>(kmers.begin(), kmers.end());
+	}
 	std::vector<unsigned> result;
-	for (unsigned kmer = 0; kmer < maskSize << MASK_SHIFT; kmer++) {
-		if (check(kmer)) {
-			result.push_back(kmer);
+	for (unsigned i = 0; i < maskSize; i++) {
+		for (unsigned long bits = mask[i]; bits; bits &= bits - 1) {
+			result.push_back((i << MASK_SHIFT) | __builtin_ctzl(bits));
+		}
+	}
+	return result;
+}
+
+std::vector<uint64_t> Pattern::expand(std::string pattern) {
+	transform(pattern.begin(), pattern.end(), pattern.begin(), ::tolower);
+	std::vector<uint64_t> result(1, 0);
+	for (char letter : pattern) {
+		const vector<unsigned>& options = lettersToInt.at(letter);
+		std::vector<uint64_t> next;
+		next.reserve(result.size() * options.size());
+		for (uint64_t prefix : result) {
+			for (unsigned option : options) {
+				next.push_back(prefix * 4 + option);
+			}
 		}
+		result.swap(next);
 	}
 	return result;
 }
@@ -8,35 +8,41 @@
 #ifndef PATTERN_H_
 #define PATTERN_H_
 
+#include "KmerSetPattern.h"
 #include <string>
 #include <map>
 #include <vector>
+#include <cstdint>
 
-/* TODO
- * Make this an interface with 2 implementations:
- * FixedSizePattern, VariableSizePattern
- * Add checks in FixedSizePattern on pattern length.
- */
 /**
  * Each possible string has a bit assigned to it
  * E.g. TGT|CTC
  * Last 3 letters are used to find a bit in int64
  * First letters - to find position in the array of int64.
+ *
+ * The mask takes 4^k bits, so it is used only up to MASK_MAX_LENGTH letters
+ * (2 MB). Longer patterns, up to MAX_LENGTH, are kept as a KmerSetPattern
+ * of their expanded kmers instead.
  */
 class Pattern {
 private:
 	const unsigned MASK_SHIFT = 6, MASK_FILTER = 63;
 	unsigned long maskSize, patternSize;
 	std::vector<unsigned long> mask;
+	KmerSetPattern kmerSet;
 	static const std::map<char, const std::vector<unsigned> > lettersToInt;
-	void recursiveAdd(unsigned start, std::string end);
 	void markPattern(unsigned kmer);
 	void init(std::string pattern);
 public:
+	static const unsigned MAX_LENGTH = 16;
+	static const unsigned MASK_MAX_LENGTH = 12;
+
 	Pattern();
 	Pattern(std::string pattern);
 	void add(std::string pattern);
 	std::vector<unsigned> getKmers() const;
+	/// All unambigious kmers described by a degenerate pattern, sorted
+	static std::vector<uint64_t> expand(std::string pattern);
 	bool check(unsigned kmer) const;
 	virtual ~Pattern() {};
 };
@@ -0,0 +1,97 @@
+#include "PatternIndex.h"
+#include "Pattern.h"
+#include "PatternWrongSizeException.hpp"
+#include "../Utils/Utils.h"
+#include <algorithm>
+#include <tuple>
+
+const unsigned PatternIndex::FORWARD;
+const unsigned PatternIndex::REVERSE;
+
+PatternIndex::PatternIndex() :
+	patternsCount(0),
+	kmersCount(0),
+	shift(31),
+	table(2, Slot({0, 0, 0}))
+{}
+
+PatternIndex::PatternIndex(const std::vector<std::string>& patterns, unsigned k, bool rc) :
+	PatternIndex()
+{
+	patternsCount = patterns.size();
+
+	// (kmer, pattern, orientation)
+	std::vector<std::tuple<unsigned, unsigned, unsigned> > entries;
+	for (unsigned patternID = 0; patternID < patterns.size(); patternID++) {
+		if (patterns[patternID].length() != k) {
+			throw PatternWrongSizeException("Pattern length differs from kmer length: " + patterns[patternID]);
+		}
+		for (unsigned kmer : Pattern::expand(patterns[patternID])) {
+			entries.push_back(std::make_tuple(kmer, patternID, FORWARD));
+			if (rc) {
+				entries.push_back(std::make_tuple(Utils::reverseComplement(kmer, k), patternID, REVERSE));
+			}
+		}
+	}
+	std::sort(entries.begin(), entries.end());
+
+	std::vector<Slot> slots;
+	for (const auto& entry : entries) {
+		unsigned kmer = std::get<0>(entry), patternID = std::get<1>(entry);
+		if (slots.empty() || slots.back().kmer != kmer) {
+			slots.push_back(Slot({kmer, (unsigned)matches.size(), 0}));
+		}
+		if (slots.back().count && matches.back().pattern == patternID) {
+			matches.back().orientation |= std::get<2>(entry);
+		} else {
+			matches.push_back(Match({patternID, std::get<2>(entry)}));
+			slots.back().count++;
+		}
+	}
+	kmersCount = slots.size();
+
+	// Load factor of at most 1/2
+	unsigned bits = 1;
+	while ((1u << bits) < 2 * slots.size()) {
+		bits++;
+	}
+	shift = 32 - bits;
+	table.assign(1u << bits, Slot({0, 0, 0}));
+	unsigned mask = (1u << bits) - 1;
+	for (const auto& slot : slots) {
+		unsigned pos = hash(slot.kmer);
+		while (table[pos].count) {
+			pos = (pos + 1) & mask;
+		}
+		table[pos] = slot;
+	}
+}
+
+inline const PatternIndex::Slot * PatternIndex::lookup(unsigned kmer) const {
+	unsigned mask = table.size() - 1;
+	for (unsigned pos = hash(kmer); table[pos].count; pos = (pos + 1) & mask) {
+		if (table[pos].kmer == kmer) {
+			return &table[pos];
+		}
+	}
+	return nullptr;
+}
+
+std::pair<const PatternIndex::Match *, const PatternIndex::Match *> PatternIndex::find(unsigned kmer) const {
+	const Slot * slot = lookup(kmer);
+	if (slot == nullptr) {
+		return std::make_pair(nullptr, nullptr);
+	}
+	const Match * first = matches.data() + slot->first;
+	return std::make_pair(first, first + slot->count);
+}
+
+unsigned PatternIndex::check(unsigned kmer, unsigned pattern) const {
+	auto found = find(kmer);
+	for (const Match * match = found.first; match != found.second; match++) {
+		if (match->pattern == pattern) {
+			return match->orientation;
+		}
+	}
+	return 0;
+}
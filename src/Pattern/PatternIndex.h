@@ -0,0 +1,53 @@
+#ifndef PATTERN_PATTERNINDEX_H_
+#define PATTERN_PATTERNINDEX_H_
+
+#include <string>
+#include <vector>
+#include <utility>
+
+/**
+ * Maps a kmer to all patterns (and their orientations) it matches in one
+ * lookup. Patterns are expanded into unambigious kmers, which are stored
+ * in an open addressing hash table pointing into a flat array of matches,
+ * so memory depends on the number of expanded kmers rather than on 4^k.
+ */
+class PatternIndex {
+public:
+	static const unsigned FORWARD = 1, REVERSE = 2;
+
+	struct Match {
+		unsigned pattern;
+		/// FORWARD and/or REVERSE
+		unsigned orientation;
+	};
+
+	PatternIndex();
+	/// With rc, reverse complements of the patterns are indexed as REVERSE matches
+	PatternIndex(const std::vector<std::string>& patterns, unsigned k, bool rc);
+
+	/// Matches of the kmer ordered by pattern ID
+	std::pair<const Match *, const Match *> find(unsigned kmer) const;
+	/// Orientations in which the kmer matches the pattern, 0 if it does not
+	unsigned check(unsigned kmer, unsigned pattern) const;
+
+	unsigned size() const { return patternsCount; };
+	unsigned getKmersCount() const { return kmersCount; };
+
+private:
+	struct Slot {
+		unsigned kmer;
+		unsigned first;
+		unsigned count;
+	};
+
+	unsigned patternsCount, kmersCount, shift;
+	std::vector<Slot> table;
+	std::vector<Match> matches;
+
+	inline unsigned hash(unsigned kmer) const {
+		return (unsigned)((kmer * 2654435761u) >> shift);
+	};
+	inline const Slot * lookup(unsigned kmer) const;
+};
+
+#endif /* PATTERN_PATTERNINDEX_H_ */
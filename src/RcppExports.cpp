@@ -6,8 +6,8 @@
 using namespace Rcpp;
 
 // massFisherTest
-NumericMatrix massFisherTest(const LogicalMatrix& experiments, const IntegerVector& sums, const List& elements, std::string altString);
-RcppExport SEXP metaRE_massFisherTest(SEXP experimentsSEXP, SEXP sumsSEXP, SEXP elementsSEXP, SEXP altStringSEXP) {
+SEXP massFisherTest(const LogicalMatrix& experiments, const IntegerVector& sums, const List& elements, std::string altString, int threads, bool sumlog, bool logp, double cutoff, std::string method, double minExpected);
+RcppExport SEXP metaRE_massFisherTest(SEXP experimentsSEXP, SEXP sumsSEXP, SEXP elementsSEXP, SEXP altStringSEXP, SEXP threadsSEXP, SEXP sumlogSEXP, SEXP logpSEXP, SEXP cutoffSEXP, SEXP methodSEXP, SEXP minExpectedSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -15,13 +15,60 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< const IntegerVector& >::type sums(sumsSEXP);
     Rcpp::traits::input_parameter< const List& >::type elements(elementsSEXP);
     Rcpp::traits::input_parameter< std::string >::type altString(altStringSEXP);
-    rcpp_result_gen = Rcpp::wrap(massFisherTest(experiments, sums, elements, altString));
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type sumlog(sumlogSEXP);
+    Rcpp::traits::input_parameter< bool >::type logp(logpSEXP);
+    Rcpp::traits::input_parameter< double >::type cutoff(cutoffSEXP);
+    Rcpp::traits::input_parameter< std::string >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< double >::type minExpected(minExpectedSEXP);
+    rcpp_result_gen = Rcpp::wrap(massFisherTest(experiments, sums, elements, altString, threads, sumlog, logp, cutoff, method, minExpected));
+    return rcpp_result_gen;
+END_RCPP
+}
+// massFisherTestCSR
+SEXP massFisherTestCSR(const LogicalMatrix& experiments, const IntegerVector& sums, const IntegerVector& offsets, const IntegerVector& genes, std::string altString, int threads, bool sumlog, bool logp, double cutoff, std::string method, double minExpected);
+RcppExport SEXP metaRE_massFisherTestCSR(SEXP experimentsSEXP, SEXP sumsSEXP, SEXP offsetsSEXP, SEXP genesSEXP, SEXP altStringSEXP, SEXP threadsSEXP, SEXP sumlogSEXP, SEXP logpSEXP, SEXP cutoffSEXP, SEXP methodSEXP, SEXP minExpectedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const LogicalMatrix& >::type experiments(experimentsSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type sums(sumsSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type offsets(offsetsSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type genes(genesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type altString(altStringSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type sumlog(sumlogSEXP);
+    Rcpp::traits::input_parameter< bool >::type logp(logpSEXP);
+    Rcpp::traits::input_parameter< double >::type cutoff(cutoffSEXP);
+    Rcpp::traits::input_parameter< std::string >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< double >::type minExpected(minExpectedSEXP);
+    rcpp_result_gen = Rcpp::wrap(massFisherTestCSR(experiments, sums, offsets, genes, altString, threads, sumlog, logp, cutoff, method, minExpected));
+    return rcpp_result_gen;
+END_RCPP
+}
+// massFisherTestBitmap
+SEXP massFisherTestBitmap(const LogicalMatrix& experiments, const IntegerVector& sums, const List& elements, std::string altString, int threads, bool sumlog, bool logp, double cutoff, std::string method, double minExpected);
+RcppExport SEXP metaRE_massFisherTestBitmap(SEXP experimentsSEXP, SEXP sumsSEXP, SEXP elementsSEXP, SEXP altStringSEXP, SEXP threadsSEXP, SEXP sumlogSEXP, SEXP logpSEXP, SEXP cutoffSEXP, SEXP methodSEXP, SEXP minExpectedSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const LogicalMatrix& >::type experiments(experimentsSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type sums(sumsSEXP);
+    Rcpp::traits::input_parameter< const List& >::type elements(elementsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type altString(altStringSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< bool >::type sumlog(sumlogSEXP);
+    Rcpp::traits::input_parameter< bool >::type logp(logpSEXP);
+    Rcpp::traits::input_parameter< double >::type cutoff(cutoffSEXP);
+    Rcpp::traits::input_parameter< std::string >::type method(methodSEXP);
+    Rcpp::traits::input_parameter< double >::type minExpected(minExpectedSEXP);
+    rcpp_result_gen = Rcpp::wrap(massFisherTestBitmap(experiments, sums, elements, altString, threads, sumlog, logp, cutoff, method, minExpected));
     return rcpp_result_gen;
 END_RCPP
 }
 // quickFisherTest
-NumericVector quickFisherTest(NumericVector eff1, NumericVector n1, NumericVector eff2, NumericVector n2, std::string alternative);
-RcppExport SEXP metaRE_quickFisherTest(SEXP eff1SEXP, SEXP n1SEXP, SEXP eff2SEXP, SEXP n2SEXP, SEXP alternativeSEXP) {
+NumericVector quickFisherTest(NumericVector eff1, NumericVector n1, NumericVector eff2, NumericVector n2, std::string alternative, bool logp);
+RcppExport SEXP metaRE_quickFisherTest(SEXP eff1SEXP, SEXP n1SEXP, SEXP eff2SEXP, SEXP n2SEXP, SEXP alternativeSEXP, SEXP logpSEXP) {
 BEGIN_RCPP
     Rcpp::RObject rcpp_result_gen;
     Rcpp::RNGScope rcpp_rngScope_gen;
@@ -30,7 +77,8 @@ BEGIN_RCPP
     Rcpp::traits::input_parameter< NumericVector >::type eff2(eff2SEXP);
     Rcpp::traits::input_parameter< NumericVector >::type n2(n2SEXP);
     Rcpp::traits::input_parameter< std::string >::type alternative(alternativeSEXP);
-    rcpp_result_gen = Rcpp::wrap(quickFisherTest(eff1, n1, eff2, n2, alternative));
+    Rcpp::traits::input_parameter< bool >::type logp(logpSEXP);
+    rcpp_result_gen = Rcpp::wrap(quickFisherTest(eff1, n1, eff2, n2, alternative, logp));
     return rcpp_result_gen;
 END_RCPP
 }
@@ -47,3 +95,58 @@ BEGIN_RCPP
     return rcpp_result_gen;
 END_RCPP
 }
+// writeGeneClassificationCpp
+void writeGeneClassificationCpp(IntegerVector offsets, IntegerVector genes, CharacterVector elementNames, CharacterVector geneNames, std::string path);
+RcppExport SEXP metaRE_writeGeneClassificationCpp(SEXP offsetsSEXP, SEXP genesSEXP, SEXP elementNamesSEXP, SEXP geneNamesSEXP, SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< IntegerVector >::type offsets(offsetsSEXP);
+    Rcpp::traits::input_parameter< IntegerVector >::type genes(genesSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type elementNames(elementNamesSEXP);
+    Rcpp::traits::input_parameter< CharacterVector >::type geneNames(geneNamesSEXP);
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    writeGeneClassificationCpp(offsets, genes, elementNames, geneNames, path);
+    return R_NilValue;
+END_RCPP
+}
+// readGeneClassificationCpp
+List readGeneClassificationCpp(std::string path);
+RcppExport SEXP metaRE_readGeneClassificationCpp(SEXP pathSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< std::string >::type path(pathSEXP);
+    rcpp_result_gen = Rcpp::wrap(readGeneClassificationCpp(path));
+    return rcpp_result_gen;
+END_RCPP
+}
+// preparePermutationTestCpp
+SEXP preparePermutationTestCpp(const LogicalMatrix& experiments, const IntegerVector& sums, const List& elements, std::string altString);
+RcppExport SEXP metaRE_preparePermutationTestCpp(SEXP experimentsSEXP, SEXP sumsSEXP, SEXP elementsSEXP, SEXP altStringSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< const LogicalMatrix& >::type experiments(experimentsSEXP);
+    Rcpp::traits::input_parameter< const IntegerVector& >::type sums(sumsSEXP);
+    Rcpp::traits::input_parameter< const List& >::type elements(elementsSEXP);
+    Rcpp::traits::input_parameter< std::string >::type altString(altStringSEXP);
+    rcpp_result_gen = Rcpp::wrap(preparePermutationTestCpp(experiments, sums, elements, altString));
+    return rcpp_result_gen;
+END_RCPP
+}
+// permutationTestCpp
+List permutationTestCpp(SEXP prepared, double seed, double first, int permutations, int threads, NumericVector limits);
+RcppExport SEXP metaRE_permutationTestCpp(SEXP preparedSEXP, SEXP seedSEXP, SEXP firstSEXP, SEXP permutationsSEXP, SEXP threadsSEXP, SEXP limitsSEXP) {
+BEGIN_RCPP
+    Rcpp::RObject rcpp_result_gen;
+    Rcpp::RNGScope rcpp_rngScope_gen;
+    Rcpp::traits::input_parameter< SEXP >::type prepared(preparedSEXP);
+    Rcpp::traits::input_parameter< double >::type seed(seedSEXP);
+    Rcpp::traits::input_parameter< double >::type first(firstSEXP);
+    Rcpp::traits::input_parameter< int >::type permutations(permutationsSEXP);
+    Rcpp::traits::input_parameter< int >::type threads(threadsSEXP);
+    Rcpp::traits::input_parameter< NumericVector >::type limits(limitsSEXP);
+    rcpp_result_gen = Rcpp::wrap(permutationTestCpp(prepared, seed, first, permutations, threads, limits));
+    return rcpp_result_gen;
+END_RCPP
+}
@@ -0,0 +1,74 @@
+#include "ApproximateTest.h"
+#include <cmath>
+
+const double ApproximateTest::DEFAULT_MIN_EXPECTED = 100;
+
+static const double LOG_SQRT_2PI = 0.918938533204672741780329736406;
+
+ApproximateTest::ApproximateTest(TestMethod approximation, double minExpected) :
+    approximation(approximation),
+    minExpected(minExpected)
+{
+    if (!(minExpected > 0)) {
+        throw std::invalid_argument("minExpected must be positive");
+    }
+}
+
+TestMethod ApproximateTest::method(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2) const {
+    if (approximation == TestMethod::EXACT) {
+        return TestMethod::EXACT;
+    }
+    double total = double(n1) + n2;
+    double effective = double(eff1) + eff2;
+    double smallest = std::min<double>(n1, n2) * std::min(effective, total - effective) / total;
+    return smallest >= minExpected ? approximation : TestMethod::EXACT;
+}
+
+static double logObservedExpected(double observed, double expected) {
+    return observed > 0 ? observed * std::log(observed / expected) : 0;
+}
+
+double ApproximateTest::logPvalue(TestMethod method, unsigned eff1, unsigned n1, unsigned eff2,
+                                  unsigned n2, Alternative alternative) const {
+    double total = double(n1) + n2;
+    double effective = double(eff1) + eff2;
+    double expected = n1 * effective / total;
+    double deviation = eff1 - expected;
+
+    // Signed root of the statistic, positive when eff1 is above its expectation
+    double z;
+    if (method == TestMethod::CHI_SQUARE) {
+        double variance = double(n1) * n2 * effective * (total - effective) / (total * total * total);
+        double corrected = std::max(std::fabs(deviation) - 0.5, 0.);
+        z = std::copysign(corrected / std::sqrt(variance), deviation);
+    } else if (method == TestMethod::G_TEST) {
+        double g = 2 * (logObservedExpected(eff1, expected) +
+                        logObservedExpected(n1 - eff1, n1 - expected) +
+                        logObservedExpected(eff2, effective - expected) +
+                        logObservedExpected(n2 - eff2, total - effective - n1 + expected));
+        z = std::copysign(std::sqrt(std::max(g, 0.)), deviation);
+    } else {
+        throw std::invalid_argument("Illegal approximation");
+    }
+
+    if (alternative == Alternative::TWO_SIDED) {
+        return std::min(std::log(2.) + logUpperNormal(std::fabs(z)), 0.);
+    } else if (alternative == Alternative::GREATER) {
+        return logUpperNormal(z);
+    } else if (alternative == Alternative::LESS) {
+        return logUpperNormal(-z);
+    } else {
+        throw std::invalid_argument("Illegal alternative");
+    }
+}
+
+double ApproximateTest::logUpperNormal(double z) {
+    // erfc keeps full relative precision up to z = 30, where the asymptotic
+    // series is already accurate to 1e-10
+    if (z < 30) {
+        return std::log(0.5 * std::erfc(z / std::sqrt(2.)));
+    }
+    double inverse = 1 / (z * z);
+    return -0.5 * z * z - std::log(z) - LOG_SQRT_2PI +
+        std::log1p(inverse * (-1 + inverse * (3 - 15 * inverse)));
+}
@@ -0,0 +1,56 @@
+#ifndef APPROXIMATETEST_H_
+#define APPROXIMATETEST_H_
+
+#include "../stat_tests.hpp"
+#include <cstdint>
+#include <string>
+
+/// How the p-value of a table is computed
+enum class TestMethod : uint8_t {EXACT, CHI_SQUARE, G_TEST};
+
+inline TestMethod strToTestMethod(std::string val) {
+    if (!val.compare("exact")) {
+        return TestMethod::EXACT;
+    } else if (!val.compare("chisq")) {
+        return TestMethod::CHI_SQUARE;
+    } else if (!val.compare("g.test")) {
+        return TestMethod::G_TEST;
+    } else {
+        throw std::invalid_argument("Illegal test method");
+    }
+}
+
+/**
+ * Asymptotic replacements for Fisher's exact test of large 2x2 tables. A table
+ * is approximated only if every expected count is at least minExpected, where
+ * the approximations are accurate and the exact tails are long.
+ *
+ * CHI_SQUARE is Pearson's test with Yates' continuity correction, as in
+ * chisq.test, G_TEST is the likelihood ratio test. One-sided p-values come
+ * from the signed square root of the statistic, two-sided ones are twice the
+ * smaller tail like in chisq.test. P-values are computed in log space, the
+ * normal tail switches to its asymptotic series where erfc underflows.
+ */
+class ApproximateTest {
+private:
+    TestMethod approximation;
+    double minExpected;
+
+public:
+    static const double DEFAULT_MIN_EXPECTED;
+
+    /// With approximation EXACT no table is approximated
+    explicit ApproximateTest(TestMethod approximation=TestMethod::EXACT,
+                             double minExpected=DEFAULT_MIN_EXPECTED);
+
+    /// Method to use for a table, depends only on its margins
+    TestMethod method(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2) const;
+    /// Natural logarithm of the p-value by an approximating method
+    double logPvalue(TestMethod method, unsigned eff1, unsigned n1, unsigned eff2, unsigned n2,
+                     Alternative alternative) const;
+
+    /// log P(Z > z) for a standard normal Z
+    static double logUpperNormal(double z);
+};
+
+#endif /* APPROXIMATETEST_H_ */
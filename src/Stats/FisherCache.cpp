@@ -0,0 +1,36 @@
+#include "FisherCache.h"
+
+const size_t FisherCache::DEFAULT_MAX_ENTRIES;
+
+FisherCache::FisherCache(const HypergeometricTable& table, Alternative alternative,
+                         size_t maxEntries, bool logarithm) :
+    table(&table),
+    alternative(alternative),
+    maxEntries(maxEntries),
+    logarithm(logarithm)
+{}
+
+std::vector<FisherCache> FisherCache::forExperiments(const HypergeometricTable& table,
+                                                     Alternative alternative, size_t experiments,
+                                                     bool logarithm, size_t maxEntries) {
+    size_t share = experiments ? maxEntries / experiments : maxEntries;
+    return std::vector<FisherCache>(experiments, FisherCache(table, alternative, share, logarithm));
+}
+
+double FisherCache::fisherTest(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2) {
+    Key key{(uint64_t(eff1) << 32) | n1, (uint64_t(eff2) << 32) | n2};
+    auto it = pvalues.find(key);
+    if (it != pvalues.end()) {
+        return it->second;
+    }
+    double pvalue = logarithm ? table->logFisherTest(eff1, n1, eff2, n2, alternative)
+                              : table->fisherTest(eff1, n1, eff2, n2, alternative);
+    if (pvalues.size() < maxEntries) {
+        pvalues.emplace(key, pvalue);
+    }
+    return pvalue;
+}
+
+size_t FisherCache::size() const {
+    return pvalues.size();
+}
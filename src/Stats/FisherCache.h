@@ -0,0 +1,57 @@
+#ifndef FISHERCACHE_H_
+#define FISHERCACHE_H_
+
+#include "HypergeometricTable.h"
+#include <unordered_map>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Memoizes HypergeometricTable::fisherTest() for one alternative. Within an
+ * experiment the number of genes and of up genes are fixed, so a p-value
+ * depends only on (elemUp, elem) and the same tables recur for every element
+ * with the same number of genes. Keeping a cache per experiment keeps each
+ * cache small; once maxEntries tables are stored, new tables are computed
+ * without being stored. A cache built with logarithm stores and returns
+ * HypergeometricTable::logFisherTest() instead. forExperiments() splits one
+ * budget of maxEntries between the caches of all experiments, so a thread's
+ * caches stay bounded however many experiments there are.
+ */
+class FisherCache {
+private:
+    struct Key {
+        uint64_t first, second;
+        bool operator==(const Key& other) const {
+            return first == other.first && second == other.second;
+        }
+    };
+    struct KeyHash {
+        size_t operator()(const Key& key) const {
+            return std::hash<uint64_t>()(key.first * 0x9E3779B97F4A7C15ULL ^ key.second);
+        }
+    };
+
+    const HypergeometricTable * table;
+    Alternative alternative;
+    size_t maxEntries;
+    bool logarithm;
+    std::unordered_map<Key, double, KeyHash> pvalues;
+
+public:
+    static const size_t DEFAULT_MAX_ENTRIES = 1 << 20;
+
+    FisherCache(const HypergeometricTable& table, Alternative alternative,
+                size_t maxEntries=DEFAULT_MAX_ENTRIES, bool logarithm=false);
+
+    /// One cache per experiment with maxEntries tables in total
+    static std::vector<FisherCache> forExperiments(const HypergeometricTable& table,
+                                                   Alternative alternative, size_t experiments,
+                                                   bool logarithm=false,
+                                                   size_t maxEntries=DEFAULT_MAX_ENTRIES);
+
+    /// Same as HypergeometricTable::fisherTest() or logFisherTest()
+    double fisherTest(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2);
+    size_t size() const;
+};
+
+#endif /* FISHERCACHE_H_ */
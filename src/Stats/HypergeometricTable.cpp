@@ -0,0 +1,221 @@
+#include "HypergeometricTable.h"
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+const double HypergeometricTable::MAX_RELATIVE_ERROR = 1e-8;
+const double HypergeometricTable::TWO_SIDED_TOLERANCE = 1e-7;
+const double HypergeometricTable::MIN_LOG_PDF =
+    std::log(std::numeric_limits<double>::min() / std::numeric_limits<double>::epsilon());
+
+HypergeometricTable::HypergeometricTable(unsigned maxTotal) {
+    // A point probability adds and subtracts nine table entries and a tail
+    // sum multiplies up to total ratios, each step rounding once more
+    const double eps = std::numeric_limits<double>::epsilon();
+    logFactorials.reserve(maxTotal + 1);
+    for (unsigned total = 0; total <= maxTotal; total++) {
+        double logFactorial = std::lgamma(total + 1.);
+        if ((9 * logFactorial + 4. * total) * eps > MAX_RELATIVE_ERROR) {
+            break;
+        }
+        logFactorials.push_back(logFactorial);
+    }
+}
+
+bool HypergeometricTable::covers(unsigned total) const {
+    return total < logFactorials.size();
+}
+
+double HypergeometricTable::logPdf(const Distribution& d, unsigned k) const {
+    const std::vector<double>& lf = logFactorials;
+    unsigned rest = d.total - d.defective;
+    return lf[d.defective] - lf[k] - lf[d.defective - k] +
+        lf[rest] - lf[d.sample - k] - lf[rest - (d.sample - k)] -
+        lf[d.total] + lf[d.sample] + lf[d.total - d.sample];
+}
+
+double HypergeometricTable::logTailSum(const Distribution& d, unsigned k, int step) const {
+    // Probabilities decrease away from the mode and so do their ratios, so the
+    // rest of the tail is bounded by a geometric series. Terms are relative to
+    // the first one, which is only added as a logarithm and can't underflow.
+    const double eps = std::numeric_limits<double>::epsilon();
+    double rest = double(d.total) - d.defective - d.sample;
+    double logFirst = logPdf(d, k);
+    double term = 1;
+    double sum = term;
+    while (step > 0 ? k < d.max : k > d.min) {
+        double ratio;
+        if (step > 0) {
+            ratio = (double(d.defective) - k) * (double(d.sample) - k) / ((k + 1.) * (rest + k + 1));
+        } else {
+            ratio = double(k) * (rest + k) / ((double(d.defective) - k + 1) * (double(d.sample) - k + 1));
+        }
+        term *= ratio;
+        sum += term;
+        k += step;
+        if (ratio < 1 && term / (1 - ratio) <= sum * eps) {
+            break;
+        }
+    }
+    return logFirst + std::log(sum);
+}
+
+double HypergeometricTable::tailSum(const Distribution& d, unsigned k, int step) const {
+    return std::exp(logTailSum(d, k, step));
+}
+
+unsigned HypergeometricTable::lastBelow(const Distribution& d, unsigned left, unsigned right,
+                                        double logCutoff) const {
+    // Probabilities don't decrease in [left, right] and logPdf(left) <= logCutoff
+    while (left < right) {
+        unsigned mid = left + (right - left + 1) / 2;
+        if (logPdf(d, mid) <= logCutoff) {
+            left = mid;
+        } else {
+            right = mid - 1;
+        }
+    }
+    return left;
+}
+
+unsigned HypergeometricTable::firstBelow(const Distribution& d, unsigned left, unsigned right,
+                                         double logCutoff) const {
+    // Probabilities don't increase in [left, right] and logPdf(right) <= logCutoff
+    while (left < right) {
+        unsigned mid = left + (right - left) / 2;
+        if (logPdf(d, mid) <= logCutoff) {
+            right = mid;
+        } else {
+            left = mid + 1;
+        }
+    }
+    return left;
+}
+
+static double logSum(double logA, double logB) {
+    double high = std::max(logA, logB);
+    return high + std::log1p(std::exp(std::min(logA, logB) - high));
+}
+
+double HypergeometricTable::logTwoSided(const Distribution& d, unsigned k, double logPk) const {
+    double logCutoff = logPk + std::log1p(TWO_SIDED_TOLERANCE);
+    double logP;
+    if (k <= d.mode) {
+        logP = logTailSum(d, lastBelow(d, k, d.mode, logCutoff), -1);
+        if (d.mode < d.max && logPdf(d, d.max) <= logCutoff) {
+            logP = logSum(logP, logTailSum(d, firstBelow(d, d.mode + 1, d.max, logCutoff), 1));
+        }
+    } else {
+        logP = logTailSum(d, firstBelow(d, d.mode + 1, k, logCutoff), 1);
+        if (logPdf(d, d.min) <= logCutoff) {
+            logP = logSum(logP, logTailSum(d, lastBelow(d, d.min, d.mode, logCutoff), -1));
+        }
+    }
+    return std::min(logP, 0.);
+}
+
+HypergeometricTable::Distribution HypergeometricTable::distribution(unsigned eff1, unsigned n1,
+                                                                    unsigned eff2, unsigned n2) {
+    Distribution d;
+    d.defective = eff1 + eff2;
+    d.sample = n1;
+    d.total = n1 + n2;
+    d.min = d.defective > n2 ? d.defective - n2 : 0;
+    d.max = std::min(d.defective, n1);
+    d.mode = double(d.defective + 1) * (n1 + 1) / (d.total + 2);
+    d.mode = std::max(d.min, std::min(d.max, d.mode));
+    return d;
+}
+
+double HypergeometricTable::fisherTest(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2,
+                                       Alternative alternative) const {
+    if (!covers(n1 + n2)) {
+        return ::fisherTest(eff1, n1, eff2, n2, alternative);
+    }
+    Distribution d = distribution(eff1, n1, eff2, n2);
+
+    double logPk = logPdf(d, eff1);
+    if (logPk < MIN_LOG_PDF) {
+        return ::fisherTest(eff1, n1, eff2, n2, alternative);
+    }
+
+    if (alternative == Alternative::TWO_SIDED) {
+        return std::exp(logTwoSided(d, eff1, logPk));
+    } else if (alternative == Alternative::GREATER) {
+        if (eff1 == d.min) {
+            return 1.;
+        }
+        if (eff1 >= d.mode) {
+            return std::min(tailSum(d, eff1, 1), 1.);
+        }
+        return std::max(1 - tailSum(d, eff1 - 1, -1), 0.);
+    } else if (alternative == Alternative::LESS) {
+        if (eff1 == d.max) {
+            return 1.;
+        }
+        if (eff1 <= d.mode) {
+            return std::min(tailSum(d, eff1, -1), 1.);
+        }
+        return std::max(1 - tailSum(d, eff1 + 1, 1), 0.);
+    } else {
+        throw std::invalid_argument("Illegal alternative");
+    }
+}
+
+double HypergeometricTable::logFisherTest(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2,
+                                          Alternative alternative) const {
+    if (!covers(n1 + n2)) {
+        return std::log(::fisherTest(eff1, n1, eff2, n2, alternative));
+    }
+    Distribution d = distribution(eff1, n1, eff2, n2);
+
+    if (alternative == Alternative::TWO_SIDED) {
+        return logTwoSided(d, eff1, logPdf(d, eff1));
+    } else if (alternative == Alternative::GREATER) {
+        if (eff1 == d.min) {
+            return 0.;
+        }
+        if (eff1 >= d.mode) {
+            return std::min(logTailSum(d, eff1, 1), 0.);
+        }
+        return std::log1p(-std::min(tailSum(d, eff1 - 1, -1), 1.));
+    } else if (alternative == Alternative::LESS) {
+        if (eff1 == d.max) {
+            return 0.;
+        }
+        if (eff1 <= d.mode) {
+            return std::min(logTailSum(d, eff1, -1), 0.);
+        }
+        return std::log1p(-std::min(tailSum(d, eff1 + 1, 1), 1.));
+    } else {
+        throw std::invalid_argument("Illegal alternative");
+    }
+}
+
+double HypergeometricTable::logPvalueBound(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2,
+                                           Alternative alternative) const {
+    if (!covers(n1 + n2)) {
+        return -std::numeric_limits<double>::infinity();
+    }
+    Distribution d = distribution(eff1, n1, eff2, n2);
+    if (d.total == 0) {
+        return 0;
+    }
+    // The median lies between the floor and the ceiling of the mean, so a
+    // one-sided tail starting on the near side of the mean holds half the mass
+    uint64_t product = (uint64_t)d.sample * d.defective;
+    uint64_t floorMean = product / d.total, ceilMean = (product + d.total - 1) / d.total;
+    unsigned k = eff1;
+    if (alternative == Alternative::GREATER) {
+        if (eff1 <= floorMean) {
+            return std::log(0.5);
+        }
+        k = std::max(eff1, d.mode);
+    } else if (alternative == Alternative::LESS) {
+        if (eff1 >= ceilMean) {
+            return std::log(0.5);
+        }
+        k = std::min(eff1, d.mode);
+    }
+    return std::min(logPdf(d, k), 0.);
+}
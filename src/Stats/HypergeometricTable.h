@@ -0,0 +1,70 @@
+#ifndef HYPERGEOMETRICTABLE_H_
+#define HYPERGEOMETRICTABLE_H_
+
+#include "../stat_tests.hpp"
+#include <vector>
+
+/**
+ * Fisher's exact test for 2x2 tables with up to maxTotal genes. Logarithms of
+ * factorials are tabulated once, so a point probability is a handful of table
+ * lookups, and tails are summed from the observed value outwards with the
+ * ratio of neighbouring probabilities, stopping when the rest of the tail is
+ * negligible. Each test thus costs O(tail length) without special functions.
+ *
+ * The two-sided p-value follows fisher.test: the sum of probabilities not
+ * greater than the observed one with a relative tolerance of 1e-7.
+ *
+ * Tables with more genes than maxTotal, tables too large for the error bound
+ * of the log-factorial sums to stay below MAX_RELATIVE_ERROR and tables whose
+ * observed log-probability is below MIN_LOG_PDF, where tail terms start to lose
+ * precision to underflow, are handed over to the boost based fisherTest().
+ *
+ * logFisherTest() sums every tail relative to its first term and adds the
+ * logarithm of that term only at the end, so it needs no MIN_LOG_PDF fallback
+ * and stays exact for p-values far below the smallest double.
+ */
+class HypergeometricTable {
+private:
+    std::vector<double> logFactorials;
+
+    /// Distribution of the number of up genes among the genes of an element
+    struct Distribution {
+        unsigned defective, sample, total;
+        unsigned min, max, mode;
+    };
+
+    static Distribution distribution(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2);
+    double logPdf(const Distribution& d, unsigned k) const;
+    double logTailSum(const Distribution& d, unsigned k, int step) const;
+    double tailSum(const Distribution& d, unsigned k, int step) const;
+    unsigned lastBelow(const Distribution& d, unsigned left, unsigned right, double logCutoff) const;
+    unsigned firstBelow(const Distribution& d, unsigned left, unsigned right, double logCutoff) const;
+    double logTwoSided(const Distribution& d, unsigned k, double logPk) const;
+
+public:
+    static const double MAX_RELATIVE_ERROR;
+    static const double TWO_SIDED_TOLERANCE;
+    static const double MIN_LOG_PDF;
+
+    explicit HypergeometricTable(unsigned maxTotal);
+
+    /// True if tables with total genes are tested without the fallback
+    bool covers(unsigned total) const;
+    /// Same arguments and result as fisherTest()
+    double fisherTest(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2,
+                      Alternative alternative) const;
+    /// Natural logarithm of the p-value, computed without leaving log space
+    double logFisherTest(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2,
+                         Alternative alternative) const;
+    /**
+     * Lower bound of logFisherTest() in O(1): the log-probability of a table
+     * in the tail, which is the observed one or, for one-sided tails that
+     * contain the mode, the most probable one. One-sided tails that start
+     * on the near side of the mean contain the median and are bounded by
+     * 1/2 instead. -Inf for tables that aren't covered.
+     */
+    double logPvalueBound(unsigned eff1, unsigned n1, unsigned eff2, unsigned n2,
+                          Alternative alternative) const;
+};
+
+#endif /* HYPERGEOMETRICTABLE_H_ */
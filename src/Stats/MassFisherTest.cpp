@@ -0,0 +1,90 @@
+#include "MassFisherTest.h"
+#include "TaskQueue.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <limits>
+
+const unsigned MassFisherTest::BLOCK;
+const double MassFisherTest::CUTOFF_TOLERANCE = 1e-7;
+const double MassFisherTest::PRUNED = std::numeric_limits<double>::quiet_NaN();
+
+MassFisherTest::MassFisherTest(unsigned totalGenes, const std::vector<unsigned>& sums,
+                               Alternative alternative, bool logarithm,
+                               const ApproximateTest& approximation) :
+    totalGenes(totalGenes),
+    sums(sums),
+    alternative(alternative),
+    logarithm(logarithm),
+    approximation(approximation),
+    table(totalGenes)
+{}
+
+double MassFisherTest::logSumlogTerm(double logPvalue) {
+    return -2 * std::max(logPvalue, std::log(std::numeric_limits<double>::denorm_min()));
+}
+
+template<class Consumer>
+void MassFisherTest::forEachPvalue(unsigned elements, const Counter& counter, unsigned threads,
+                                   bool logPvalues, double cutoff, Consumer consume) const {
+    const bool prune = cutoff < 1;
+    const double logCutoff = std::log(cutoff) + CUTOFF_TOLERANCE;
+    TaskQueue queue((elements + BLOCK - 1) / BLOCK);
+    queue.run(threads, [&](unsigned) {
+        std::vector<FisherCache> caches = FisherCache::forExperiments(table, alternative, sums.size(),
+                                                                      logPvalues);
+        std::vector<unsigned> counts(sums.size());
+        unsigned block;
+        while (queue.next(block)) {
+            unsigned last = std::min(elements, (block + 1) * BLOCK);
+            for (unsigned element = block * BLOCK; element < last; element++) {
+                unsigned elem = counter(element, counts.data());
+                for (unsigned experiment = 0; experiment < sums.size(); experiment++) {
+                    unsigned elemUp = counts[experiment];
+                    unsigned restUp = sums[experiment] - elemUp;
+                    unsigned rest = totalGenes - elem;
+                    TestMethod method = approximation.method(elemUp, elem, restUp, rest);
+                    if (method != TestMethod::EXACT) {
+                        double logPvalue = approximation.logPvalue(method, elemUp, elem, restUp, rest,
+                                                                   alternative);
+                        consume(element, experiment, logPvalues ? logPvalue : std::exp(logPvalue),
+                                method);
+                    } else if (prune && table.logPvalueBound(elemUp, elem, restUp, rest,
+                                                             alternative) > logCutoff) {
+                        consume(element, experiment, PRUNED, method);
+                    } else {
+                        consume(element, experiment, caches[experiment].fisherTest(
+                            elemUp, elem, restUp, rest), method);
+                    }
+                }
+            }
+        }
+    });
+}
+
+void MassFisherTest::run(unsigned elements, const Counter& counter, double * result,
+                         unsigned threads, double cutoff, TestMethod * methods) const {
+    forEachPvalue(elements, counter, threads, logarithm, cutoff,
+                  [result, methods, elements](unsigned element, unsigned experiment, double pvalue,
+                                              TestMethod method) {
+        size_t cell = element + (size_t)experiment * elements;
+        result[cell] = pvalue;
+        if (methods) {
+            methods[cell] = method;
+        }
+    });
+}
+
+size_t MassFisherTest::runSumlog(unsigned elements, const Counter& counter, double * statistics,
+                                 unsigned threads) const {
+    std::fill(statistics, statistics + elements, 0.);
+    std::atomic<size_t> zeros(0);
+    forEachPvalue(elements, counter, threads, true, 1,
+                  [statistics, &zeros](unsigned element, unsigned, double logPvalue, TestMethod) {
+        if (std::isinf(logPvalue)) {
+            zeros++;
+        }
+        statistics[element] += logSumlogTerm(logPvalue);
+    });
+    return zeros;
+}
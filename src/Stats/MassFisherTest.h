@@ -0,0 +1,78 @@
+#ifndef MASSFISHERTEST_H_
+#define MASSFISHERTEST_H_
+
+#include "ApproximateTest.h"
+#include "FisherCache.h"
+#include <functional>
+#include <vector>
+
+/**
+ * Fisher tests of every element against every experiment. Elements are
+ * split into blocks of BLOCK consecutive elements, so that a thread writes
+ * contiguous runs of every result column, and threads take blocks from a
+ * shared counter. Every thread has its own p-value caches. A p-value depends
+ * only on its table, so the result doesn't depend on the number of threads.
+ *
+ * runSumlog() fuses the tests with Fisher's sum-of-logs method: it keeps only
+ * -2 * sum of log p-values per element and never stores the p-value matrix.
+ * It always takes the p-values from HypergeometricTable::logFisherTest(), so
+ * p-values below the smallest double are summed exactly instead of clamped.
+ *
+ * run() with a cutoff below 1 prunes the cells whose p-value can't reach it:
+ * HypergeometricTable::logPvalueBound() rules out most tables of elements
+ * near their expected number of up genes in O(1), such cells are set to
+ * PRUNED instead of being tested.
+ *
+ * Tables with large enough expected counts can be handed over to an
+ * ApproximateTest, run() reports the method used for every cell. Pruning
+ * applies only to exactly tested cells, approximations are O(1) anyway.
+ *
+ * Neither the counter nor anything else run by the worker threads may call
+ * the R API.
+ */
+class MassFisherTest {
+public:
+    /// Fills counts[e] with elemUp of an element in experiment e and returns elem
+    typedef std::function<unsigned (unsigned element, unsigned * counts)> Counter;
+
+    static const unsigned BLOCK = 256;
+    /// Relative margin of the pruning bound for its rounding errors
+    static const double CUTOFF_TOLERANCE;
+    /// Value of pruned cells
+    static const double PRUNED;
+
+    MassFisherTest(unsigned totalGenes, const std::vector<unsigned>& sums, Alternative alternative,
+                   bool logarithm=false, const ApproximateTest& approximation=ApproximateTest());
+
+    /**
+     * result is a column-major elements x experiments matrix, of log p-values
+     * with logarithm. methods, if given, is a matrix of the same shape.
+     */
+    void run(unsigned elements, const Counter& counter, double * result, unsigned threads=1,
+             double cutoff=1, TestMethod * methods=nullptr) const;
+    /**
+     * Fills statistics with -2 * sum of log p-values of every element. The
+     * rare zero p-values of tables too large for the table are replaced by the
+     * smallest double like in bulkSumlog. Returns the number of such p-values.
+     */
+    size_t runSumlog(unsigned elements, const Counter& counter, double * statistics,
+                     unsigned threads=1) const;
+
+    /// Term of a log p-value in the sum-of-logs statistic
+    static double logSumlogTerm(double logPvalue);
+
+private:
+    unsigned totalGenes;
+    std::vector<unsigned> sums;
+    Alternative alternative;
+    bool logarithm;
+    ApproximateTest approximation;
+    HypergeometricTable table;
+
+    /// Calls consume(element, experiment, pvalue, method) for every cell, experiments in order
+    template<class Consumer>
+    void forEachPvalue(unsigned elements, const Counter& counter, unsigned threads,
+                       bool logPvalues, double cutoff, Consumer consume) const;
+};
+
+#endif /* MASSFISHERTEST_H_ */
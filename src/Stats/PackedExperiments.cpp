@@ -0,0 +1,126 @@
+#include "PackedExperiments.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define POPCOUNT_X86 1
+#include <immintrin.h>
+#endif
+
+unsigned andPopcountScalar(const uint64_t * a, const uint64_t * b, size_t words) {
+    unsigned count = 0;
+    for (size_t word = 0; word < words; word++) {
+        count += __builtin_popcountll(a[word] & b[word]);
+    }
+    return count;
+}
+
+#ifdef POPCOUNT_X86
+
+// Bytes are counted by looking their nibbles up with a shuffle, summed by
+// sad against zero into the four 64-bit lanes
+__attribute__((target("avx2,popcnt")))
+unsigned andPopcountAVX2(const uint64_t * a, const uint64_t * b, size_t words) {
+    const __m256i lookup = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4,
+                                            0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+    const __m256i low = _mm256_set1_epi8(0x0f);
+    __m256i total = _mm256_setzero_si256();
+    size_t word = 0;
+    for (; word + 4 <= words; word += 4) {
+        __m256i x = _mm256_and_si256(_mm256_loadu_si256((const __m256i *)(a + word)),
+                                     _mm256_loadu_si256((const __m256i *)(b + word)));
+        __m256i bytes = _mm256_add_epi8(
+            _mm256_shuffle_epi8(lookup, _mm256_and_si256(x, low)),
+            _mm256_shuffle_epi8(lookup, _mm256_and_si256(_mm256_srli_epi16(x, 4), low))
+        );
+        total = _mm256_add_epi64(total, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+    }
+    uint64_t lanes[4];
+    _mm256_storeu_si256((__m256i *)lanes, total);
+    unsigned count = lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    for (; word < words; word++) {
+        count += __builtin_popcountll(a[word] & b[word]);
+    }
+    return count;
+}
+
+bool andPopcountAVX2Supported() {
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+}
+
+#else
+
+unsigned andPopcountAVX2(const uint64_t * a, const uint64_t * b, size_t words) {
+    return andPopcountScalar(a, b, words);
+}
+
+bool andPopcountAVX2Supported() {
+    return false;
+}
+
+#endif
+
+AndPopcountKernel getAndPopcountKernel() {
+    if (andPopcountAVX2Supported()) {
+        return &andPopcountAVX2;
+    }
+    return &andPopcountScalar;
+}
+
+const unsigned PackedExperiments::DENSE_RATIO;
+
+PackedExperiments::PackedExperiments(unsigned genes, unsigned experiments) :
+    genes(genes),
+    columns(experiments, std::vector<uint64_t>((genes + 63) / 64, 0))
+{}
+
+void PackedExperiments::set(unsigned gene, unsigned experiment) {
+    columns[experiment][gene >> 6] |= (uint64_t)1 << (gene & 63);
+}
+
+unsigned PackedExperiments::getGeneCount() const {
+    return genes;
+}
+
+unsigned PackedExperiments::getExperimentCount() const {
+    return columns.size();
+}
+
+const std::vector<uint64_t>& PackedExperiments::getColumn(unsigned experiment) const {
+    return columns[experiment];
+}
+
+void PackedExperiments::countUp(const int * elementGenes, size_t size, unsigned * counts,
+                                const unsigned * permutation) const {
+    size_t words = (genes + 63) / 64;
+    auto geneAt = [elementGenes, permutation](size_t i) -> unsigned {
+        unsigned gene = elementGenes[i] - 1;
+        return permutation ? permutation[gene] : gene;
+    };
+    if (size >= DENSE_RATIO * words) {
+        std::vector<uint64_t> element(words, 0);
+        for (size_t i = 0; i < size; i++) {
+            unsigned gene = geneAt(i);
+            element[gene >> 6] |= (uint64_t)1 << (gene & 63);
+        }
+        static const AndPopcountKernel andPopcount = getAndPopcountKernel();
+        for (size_t experiment = 0; experiment < columns.size(); experiment++) {
+            counts[experiment] = andPopcount(element.data(), columns[experiment].data(), words);
+        }
+    } else {
+        for (size_t experiment = 0; experiment < columns.size(); experiment++) {
+            const uint64_t * column = columns[experiment].data();
+            unsigned count = 0;
+            for (size_t i = 0; i < size; i++) {
+                unsigned gene = geneAt(i);
+                count += (column[gene >> 6] >> (gene & 63)) & 1;
+            }
+            counts[experiment] = count;
+        }
+    }
+}
+
+void PackedExperiments::countUp(const GeneBitmap& elementGenes, unsigned * counts) const {
+    for (size_t experiment = 0; experiment < columns.size(); experiment++) {
+        counts[experiment] = elementGenes.intersectionCount(columns[experiment]);
+    }
+}
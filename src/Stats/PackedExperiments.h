@@ -0,0 +1,57 @@
+#ifndef PACKEDEXPERIMENTS_H_
+#define PACKEDEXPERIMENTS_H_
+
+#include "../DataStructures/GeneBitmap.h"
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+/**
+ * Experiments of a GeneClassificationMatrix packed into one bitset of up
+ * genes per experiment, 32 times smaller than the logical matrix. countUp()
+ * gives the number of up genes of an element in every experiment: elements
+ * with few genes test their bits in every column, elements with at least
+ * DENSE_RATIO genes per column word are packed into a bitset themselves and
+ * intersected with the columns by popcounts of ANDed words, with an AVX2
+ * kernel where the CPU supports it.
+ */
+class PackedExperiments {
+private:
+    unsigned genes;
+    std::vector<std::vector<uint64_t> > columns;
+
+public:
+    static const unsigned DENSE_RATIO = 2;
+
+    PackedExperiments(unsigned genes, unsigned experiments);
+
+    /// Marks a 0-based gene as up in an experiment
+    void set(unsigned gene, unsigned experiment);
+    unsigned getGeneCount() const;
+    unsigned getExperimentCount() const;
+    const std::vector<uint64_t>& getColumn(unsigned experiment) const;
+
+    /**
+     * counts[e] = number of up genes in experiment e among 1-based genes.
+     * With a permutation 0-based gene g takes the annotation of gene
+     * permutation[g], as if the experiments were row-shuffled.
+     */
+    void countUp(const int * elementGenes, size_t size, unsigned * counts,
+                 const unsigned * permutation=nullptr) const;
+    /// Same for 0-based genes in a bitmap
+    void countUp(const GeneBitmap& elementGenes, unsigned * counts) const;
+};
+
+typedef unsigned (*AndPopcountKernel)(const uint64_t * a, const uint64_t * b, size_t words);
+
+/// Number of bits set in both a and b
+unsigned andPopcountScalar(const uint64_t * a, const uint64_t * b, size_t words);
+unsigned andPopcountAVX2(const uint64_t * a, const uint64_t * b, size_t words);
+
+/// Kernel availability on the running CPU
+bool andPopcountAVX2Supported();
+
+/// Best kernel for the running CPU
+AndPopcountKernel getAndPopcountKernel();
+
+#endif /* PACKEDEXPERIMENTS_H_ */
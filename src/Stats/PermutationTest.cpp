@@ -0,0 +1,147 @@
+#include "PermutationTest.h"
+#include "MassFisherTest.h"
+#include "TaskQueue.h"
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <random>
+
+const unsigned PermutationTest::ROUND;
+const unsigned PermutationTest::NO_LIMIT = std::numeric_limits<unsigned>::max();
+
+PermutationTest::PermutationTest(const PackedExperiments& experiments,
+                                 const std::vector<unsigned>& sums, Alternative alternative,
+                                 const std::vector<const int *>& starts,
+                                 const std::vector<unsigned>& sizes) :
+    experiments(experiments),
+    sums(sums),
+    alternative(alternative),
+    table(experiments.getGeneCount()),
+    starts(starts),
+    sizes(sizes),
+    statistics(starts.size())
+{
+    std::vector<FisherCache> caches = makeCaches();
+    std::vector<unsigned> counts(sums.size());
+    for (unsigned element = 0; element < starts.size(); element++) {
+        statistics[element] = statistic(element, nullptr, caches, counts);
+    }
+}
+
+const std::vector<double>& PermutationTest::getStatistics() const {
+    return statistics;
+}
+
+std::vector<FisherCache> PermutationTest::makeCaches() const {
+    // Row shuffles keep the number of up genes in every experiment
+    return FisherCache::forExperiments(table, alternative, sums.size(), true);
+}
+
+double PermutationTest::statistic(unsigned element, const unsigned * permutation,
+                                  std::vector<FisherCache>& caches,
+                                  std::vector<unsigned>& counts) const {
+    unsigned total = experiments.getGeneCount();
+    unsigned elem = sizes[element];
+    experiments.countUp(starts[element], elem, counts.data(), permutation);
+    double result = 0;
+    for (unsigned experiment = 0; experiment < sums.size(); experiment++) {
+        unsigned elemUp = counts[experiment];
+        result += MassFisherTest::logSumlogTerm(caches[experiment].fisherTest(
+            elemUp, elem, sums[experiment] - elemUp, total - elem));
+    }
+    return result;
+}
+
+void PermutationTest::permute(uint64_t seed, uint64_t permutation, std::vector<unsigned>& genes) {
+    std::seed_seq sequence({uint32_t(seed), uint32_t(seed >> 32),
+                            uint32_t(permutation), uint32_t(permutation >> 32)});
+    std::mt19937_64 generator(sequence);
+    std::iota(genes.begin(), genes.end(), 0);
+    for (uint64_t i = genes.size(); i > 1; i--) {
+        // Unbiased draw from [0, i), std::uniform_int_distribution differs between libraries
+        uint64_t threshold = (0 - i) % i, value;
+        do {
+            value = generator();
+        } while (value < threshold);
+        std::swap(genes[i - 1], genes[value % i]);
+    }
+}
+
+PermutationTest::Counts PermutationTest::run(uint64_t seed, uint64_t first,
+                                             unsigned permutations, unsigned threads,
+                                             const std::vector<unsigned>& limits) const {
+    unsigned elements = starts.size();
+    Counts result;
+    result.leq.assign(elements, 0);
+    result.permutations.assign(elements, permutations);
+    std::vector<unsigned> remaining = limits.empty() ? std::vector<unsigned>(elements, NO_LIMIT) : limits;
+    std::vector<unsigned> active;
+    for (unsigned element = 0; element < elements; element++) {
+        if (remaining[element] > 0) {
+            active.push_back(element);
+        } else {
+            result.permutations[element] = 0;
+        }
+    }
+
+    struct Worker {
+        std::vector<FisherCache> caches;
+        std::vector<unsigned> counts;
+        std::vector<unsigned> permutation;
+        std::vector<uint64_t> hits;
+    };
+    threads = std::max(1u, std::min(threads, ROUND));
+    std::vector<Worker> workers(threads);
+    for (auto& worker : workers) {
+        worker.caches = makeCaches();
+        worker.counts.resize(sums.size());
+        worker.permutation.resize(experiments.getGeneCount());
+    }
+
+    for (unsigned done = 0; done < permutations && !active.empty(); done += ROUND) {
+        // Bit j of hits[i] is set if permutation first+done+j exceeded for element active[i]
+        for (auto& worker : workers) {
+            worker.hits.assign(active.size(), 0);
+        }
+        TaskQueue queue(std::min(ROUND, permutations - done));
+        queue.run(threads, [&](unsigned thread) {
+            Worker& worker = workers[thread];
+            unsigned task;
+            while (queue.next(task)) {
+                permute(seed, first + done + task, worker.permutation);
+                for (unsigned i = 0; i < active.size(); i++) {
+                    unsigned element = active[i];
+                    if (statistic(element, worker.permutation.data(), worker.caches, worker.counts) >=
+                        statistics[element]) {
+                        worker.hits[i] |= (uint64_t)1 << task;
+                    }
+                }
+            }
+        });
+
+        std::vector<unsigned> stillActive;
+        for (unsigned i = 0; i < active.size(); i++) {
+            unsigned element = active[i];
+            uint64_t hits = 0;
+            for (const auto& worker : workers) {
+                hits |= worker.hits[i];
+            }
+            unsigned count = __builtin_popcountll(hits);
+            if (count < remaining[element]) {
+                result.leq[element] += count;
+                remaining[element] -= count;
+                stillActive.push_back(element);
+                continue;
+            }
+            // Stop at the exceedance which reaches the limit
+            for (unsigned skip = 1; skip < remaining[element]; skip++) {
+                hits &= hits - 1;
+            }
+            result.leq[element] += remaining[element];
+            result.permutations[element] = done + __builtin_ctzll(hits) + 1;
+            remaining[element] = 0;
+        }
+        active.swap(stillActive);
+    }
+    return result;
+}
@@ -0,0 +1,75 @@
+#ifndef PERMUTATIONTEST_H_
+#define PERMUTATIONTEST_H_
+
+#include "FisherCache.h"
+#include "PackedExperiments.h"
+#include <cstdint>
+#include <vector>
+
+/**
+ * Permutation test of sum-of-logs meta statistics. A permutation assigns
+ * the annotation of gene permutation[g] to gene g, which is what shuffling
+ * the rows of a GeneClassificationMatrix does, without copying the matrix:
+ * contingency tables are counted on packed experiments through the
+ * permutation and tested with cached Fisher tests in log space, like in
+ * MassFisherTest::runSumlog().
+ *
+ * Permutation i shuffles the identity with a generator seeded by (seed, i),
+ * so the counts depend only on the seed and on the permutation numbers, not
+ * on the number of threads or on how permutations are split into runs.
+ *
+ * An element can stop early after a given number of exceedances
+ * (permutations with a statistic not less than the real one), which is the
+ * sequential test of Besag and Clifford. Permutations are run in rounds of
+ * ROUND consecutive permutations, exceedances of a round are collected as
+ * bitmasks and an element stops at its exceedance with the right number,
+ * so early stopping keeps the result independent of the threads as well.
+ *
+ * Elements are 1-based gene vectors given by starts and sizes, which must
+ * outlive the test.
+ */
+class PermutationTest {
+public:
+    struct Counts {
+        /// Exceedances per element
+        std::vector<unsigned> leq;
+        /// Permutations run per element, less than requested if it stopped
+        std::vector<unsigned> permutations;
+    };
+
+    static const unsigned ROUND = 64;
+    static const unsigned NO_LIMIT;
+
+    PermutationTest(const PackedExperiments& experiments, const std::vector<unsigned>& sums,
+                    Alternative alternative, const std::vector<const int *>& starts,
+                    const std::vector<unsigned>& sizes);
+
+    /// -2 * sum of log p-values of every element on the real annotation
+    const std::vector<double>& getStatistics() const;
+    /**
+     * Runs permutations first..first+permutations-1 and counts, per element,
+     * exceedances, i.e. permutations with a meta p-value less or equal to
+     * the real one. Element i stops after limits[i] exceedances, an empty
+     * limits means NO_LIMIT for every element.
+     */
+    Counts run(uint64_t seed, uint64_t first, unsigned permutations, unsigned threads=1,
+               const std::vector<unsigned>& limits=std::vector<unsigned>()) const;
+
+    /// Fisher-Yates shuffle of the identity of genes.size() genes
+    static void permute(uint64_t seed, uint64_t permutation, std::vector<unsigned>& genes);
+
+private:
+    PackedExperiments experiments;
+    std::vector<unsigned> sums;
+    Alternative alternative;
+    HypergeometricTable table;
+    std::vector<const int *> starts;
+    std::vector<unsigned> sizes;
+    std::vector<double> statistics;
+
+    double statistic(unsigned element, const unsigned * permutation,
+                     std::vector<FisherCache>& caches, std::vector<unsigned>& counts) const;
+    std::vector<FisherCache> makeCaches() const;
+};
+
+#endif /* PERMUTATIONTEST_H_ */
@@ -0,0 +1,49 @@
+#include "TaskQueue.h"
+#include <algorithm>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+TaskQueue::TaskQueue(unsigned tasks) :
+    tasks(tasks),
+    nextTask(0)
+{}
+
+bool TaskQueue::next(unsigned& task) {
+    task = nextTask++;
+    return task < tasks;
+}
+
+void TaskQueue::stop() {
+    nextTask = tasks;
+}
+
+void TaskQueue::run(unsigned threads, const std::function<void(unsigned)>& worker) {
+    threads = std::max(1u, std::min(threads, tasks));
+    std::exception_ptr error;
+    std::mutex errorMutex;
+    auto guarded = [&](unsigned thread) {
+        try {
+            worker(thread);
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex);
+            if (!error) {
+                error = std::current_exception();
+            }
+            stop();
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (unsigned thread = 1; thread < threads; thread++) {
+        pool.emplace_back(guarded, thread);
+    }
+    guarded(0);
+    for (auto& thread : pool) {
+        thread.join();
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
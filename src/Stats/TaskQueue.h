@@ -0,0 +1,30 @@
+#ifndef TASKQUEUE_H_
+#define TASKQUEUE_H_
+
+#include <atomic>
+#include <functional>
+
+/**
+ * Hands out task indices 0..tasks-1 to threads. run() starts the workers,
+ * the calling thread being one of them, and waits for them. If a worker
+ * throws, the queue stops handing out tasks and run() rethrows the first
+ * exception once all workers are done.
+ */
+class TaskQueue {
+private:
+    unsigned tasks;
+    std::atomic<unsigned> nextTask;
+
+public:
+    explicit TaskQueue(unsigned tasks);
+    TaskQueue(const TaskQueue&) = delete;
+    TaskQueue& operator=(const TaskQueue&) = delete;
+
+    /// Takes the next task, returns false when there are none left
+    bool next(unsigned& task);
+    void stop();
+    /// Runs worker(thread) in min(threads, tasks) threads numbered from 0, at least one
+    void run(unsigned threads, const std::function<void(unsigned)>& worker);
+};
+
+#endif /* TASKQUEUE_H_ */
@@ -1,49 +1,207 @@
 #include <Rcpp.h>
 #include "stat_tests.hpp"
+#include "Stats/MassFisherTest.h"
+#include "Stats/PackedExperiments.h"
+#include "Stats/PermutationTest.h"
 using namespace Rcpp;
 
-inline unsigned getIndex(int element, int experiment, int elements) {
-    return element + experiment*elements;
+PackedExperiments packExperiments(const LogicalMatrix& experiments) {
+    PackedExperiments packed(experiments.nrow(), experiments.ncol());
+    for (unsigned experiment = 0; experiment < experiments.ncol(); experiment++) {
+        for (unsigned gene = 0; gene < experiments.nrow(); gene++) {
+            if (experiments(gene, experiment)) {
+                packed.set(gene, experiment);
+            }
+        }
+    }
+    return packed;
 }
 
-// [[Rcpp::export]]
-NumericMatrix massFisherTest(const LogicalMatrix& experiments, const IntegerVector& sums,
-                             const List& elements, std::string altString) {
-    // Initializing
-    Alternative alternative = strToAlternative(altString);
-    unsigned resultSize = elements.size() * experiments.ncol();
-    NumericMatrix result(elements.size(), experiments.ncol());
+// Gene vectors of list elements, located before worker threads start as they must not touch R
+struct ElementGenes {
+    std::vector<const int *> starts;
+    std::vector<unsigned> sizes;
+    std::vector<std::vector<int> > converted;
 
-    unsigned totalGenes = experiments.nrow();
-    unsigned elem, noElem, elemUp, noElemUp;
+    explicit ElementGenes(const List& elements) :
+        starts(elements.size()),
+        sizes(elements.size()),
+        converted(elements.size())
+    {
+        for (unsigned element = 0; element < elements.size(); element++ ) {
+            SEXP genes = elements[element];
+            sizes[element] = LENGTH(genes);
+            if (TYPEOF(genes) == INTSXP) {
+                starts[element] = INTEGER(genes);
+            } else {
+                converted[element] = as<std::vector<int> >(genes);
+                starts[element] = converted[element].data();
+            }
+        }
+    }
+};
 
-    for (unsigned element = 0; element < elements.size(); element++ ) {
-        int regGenes = LENGTH(elements[element]);
-        std::vector<int> geneIndices = as<std::vector<int> >(elements[element]);
-        for (unsigned experiment = 0; experiment < experiments.ncol(); experiment++) {
-            unsigned index = getIndex(element, experiment, elements.size());
-            elem = regGenes;
-            noElem = totalGenes - regGenes;
-            elemUp = 0;
-            for (unsigned gene = 0; gene < regGenes; gene++) {
-                if (experiments(geneIndices[gene]-1, experiment)) {
-                    elemUp++;
+SEXP massTest(const LogicalMatrix& experiments, const IntegerVector& sums, std::string altString,
+              unsigned elements, const MassFisherTest::Counter& counter, int threads, bool sumlog,
+              bool logp, double cutoff, std::string method, double minExpected) {
+    // Either the elements x experiments matrix of p-values (or of their logs)
+    // or, with sumlog, meta p-values by Fisher's method without the matrix.
+    // Cells pruned by the cutoff are NA. With an approximating method the
+    // matrix has a "method" attribute with the TestMethod code of every cell.
+    std::vector<unsigned> upGenes(sums.begin(), sums.end());
+    ApproximateTest approximation(strToTestMethod(method), minExpected);
+    MassFisherTest test(experiments.nrow(), upGenes, strToAlternative(altString), logp,
+                        approximation);
+    if (!sumlog) {
+        NumericMatrix result(elements, experiments.ncol());
+        bool approximate = strToTestMethod(method) != TestMethod::EXACT;
+        std::vector<TestMethod> methods(approximate ? result.size() : 0);
+        test.run(elements, counter, result.begin(), threads, cutoff,
+                 approximate ? methods.data() : nullptr);
+        if (cutoff < 1) {
+            for (double& pvalue : result) {
+                if (std::isnan(pvalue)) {
+                    pvalue = NA_REAL;
                 }
             }
-            noElemUp = sums[experiment] - elemUp;
-            result[index] = fisherTest(elemUp, elem, noElemUp, noElem, alternative);
         }
+        if (approximate) {
+            IntegerMatrix codes(elements, experiments.ncol());
+            for (size_t cell = 0; cell < methods.size(); cell++) {
+                codes[cell] = static_cast<int>(methods[cell]);
+            }
+            result.attr("method") = codes;
+        }
+        return result;
     }
-    return result;
+    NumericVector statistics(elements), pvalues(elements), logPvalues(elements);
+    size_t zeros = test.runSumlog(elements, counter, statistics.begin(), threads);
+    for (unsigned element = 0; element < elements; element++) {
+        pvalues[element] = R::pchisq(statistics[element], 2. * experiments.ncol(), 0, 0);
+        logPvalues[element] = R::pchisq(statistics[element], 2. * experiments.ncol(), 0, 1);
+    }
+    return List::create(
+        Named("statistic") = statistics,
+        Named("p.value") = pvalues,
+        Named("log.p.value") = logPvalues,
+        Named("zeros") = (double)zeros
+    );
 }
 
+// [[Rcpp::export]]
+SEXP massFisherTest(const LogicalMatrix& experiments, const IntegerVector& sums,
+                    const List& elements, std::string altString, int threads = 1,
+                    bool sumlog = false, bool logp = false,
+                    double cutoff = 1, std::string method = "exact", double minExpected = 100) {
+    PackedExperiments packed = packExperiments(experiments);
+    ElementGenes genes(elements);
+    return massTest(experiments, sums, altString, elements.size(),
+                    [&](unsigned element, unsigned * counts) {
+        packed.countUp(genes.starts[element], genes.sizes[element], counts);
+        return genes.sizes[element];
+    }, threads, sumlog, logp, cutoff, method, minExpected);
+}
+
+// [[Rcpp::export]]
+SEXP massFisherTestCSR(const LogicalMatrix& experiments, const IntegerVector& sums,
+                       const IntegerVector& offsets, const IntegerVector& genes,
+                       std::string altString, int threads = 1, bool sumlog = false, bool logp = false,
+                       double cutoff = 1, std::string method = "exact",
+                       double minExpected = 100) {
+    // Same as massFisherTest, genes of element i are genes[offsets[i]..offsets[i+1])
+    PackedExperiments packed = packExperiments(experiments);
+    const int * offsetData = offsets.begin();
+    const int * geneData = genes.begin();
+    return massTest(experiments, sums, altString, offsets.size() - 1,
+                    [&](unsigned element, unsigned * counts) {
+        unsigned elem = offsetData[element+1] - offsetData[element];
+        packed.countUp(geneData + offsetData[element], elem, counts);
+        return elem;
+    }, threads, sumlog, logp, cutoff, method, minExpected);
+}
+
+// [[Rcpp::export]]
+SEXP massFisherTestBitmap(const LogicalMatrix& experiments, const IntegerVector& sums,
+                          const List& elements, std::string altString, int threads = 1,
+                          bool sumlog = false, bool logp = false,
+                          double cutoff = 1, std::string method = "exact",
+                          double minExpected = 100) {
+    // Same as massFisherTest, elements are serialized GeneBitmaps with 0-based genes
+    PackedExperiments packed = packExperiments(experiments);
+    std::vector<const uint8_t *> starts(elements.size());
+    std::vector<size_t> sizes(elements.size());
+    for (unsigned element = 0; element < elements.size(); element++ ) {
+        SEXP raw = elements[element];
+        starts[element] = RAW(raw);
+        sizes[element] = LENGTH(raw);
+    }
+    return massTest(experiments, sums, altString, elements.size(),
+                    [&](unsigned element, unsigned * counts) {
+        GeneBitmap genes = GeneBitmap::deserialize(starts[element], sizes[element]);
+        if (genes.cardinality() > packed.getGeneCount()) {
+            throw std::invalid_argument("Gene bitmap has more genes than the experiments");
+        }
+        packed.countUp(genes, counts);
+        return genes.cardinality();
+    }, threads, sumlog, logp, cutoff, method, minExpected);
+}
 
 // [[Rcpp::export]]
 NumericVector quickFisherTest(NumericVector eff1, NumericVector n1, NumericVector eff2, NumericVector n2,
-                            std::string alternative){
+                            std::string alternative, bool logp = false){
     NumericVector result(eff1.length());
+    double maxTotal = 0;
     for (unsigned i = 0; i < eff1.length(); i++) {
-        result[i] = fisherTest(eff1[i], n1[i], eff2[i], n2[i], strToAlternative(alternative));
+        maxTotal = std::max(maxTotal, n1[i] + n2[i]);
+    }
+    HypergeometricTable table(maxTotal);
+    FisherCache cache(table, strToAlternative(alternative), FisherCache::DEFAULT_MAX_ENTRIES, logp);
+    for (unsigned i = 0; i < eff1.length(); i++) {
+        result[i] = cache.fisherTest(eff1[i], n1[i], eff2[i], n2[i]);
     }
     return result;
 }
+
+// Permutation test packed once per analysis and shared by all its runs, the
+// elements list is kept to protect the gene vectors the test points to
+struct PreparedPermutationTest {
+    List elements;
+    ElementGenes genes;
+    PermutationTest test;
+
+    PreparedPermutationTest(const LogicalMatrix& experiments, const IntegerVector& sums,
+                            const List& elements, Alternative alternative) :
+        elements(elements),
+        genes(this->elements),
+        test(packExperiments(experiments), std::vector<unsigned>(sums.begin(), sums.end()),
+             alternative, genes.starts, genes.sizes)
+    {}
+};
+
+// [[Rcpp::export]]
+SEXP preparePermutationTestCpp(const LogicalMatrix& experiments, const IntegerVector& sums,
+                               const List& elements, std::string altString) {
+    return XPtr<PreparedPermutationTest>(
+        new PreparedPermutationTest(experiments, sums, elements, strToAlternative(altString)), true);
+}
+
+// [[Rcpp::export]]
+List permutationTestCpp(SEXP prepared, double seed, double first, int permutations,
+                        int threads, NumericVector limits) {
+    // Runs permutations first..first+permutations-1 of a prepared test, element
+    // i stops after limits[i] permutations with a meta p-value less or equal to
+    // the real one, elements with a zero limit are skipped
+    XPtr<PreparedPermutationTest> test(prepared);
+    std::vector<unsigned> elementLimits;
+    for (double limit : limits) {
+        elementLimits.push_back(limit < PermutationTest::NO_LIMIT ? limit : PermutationTest::NO_LIMIT);
+    }
+    if (elementLimits.size() != test->genes.sizes.size()) {
+        stop("limits must have a value for every element");
+    }
+    PermutationTest::Counts counts = test->test.run(seed, first, permutations, threads, elementLimits);
+    return List::create(
+        Named("leq") = NumericVector(counts.leq.begin(), counts.leq.end()),
+        Named("permutations") = NumericVector(counts.permutations.begin(), counts.permutations.end())
+    );
+}
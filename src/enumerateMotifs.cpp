@@ -3,6 +3,8 @@
 #include <cstdio>
 #include <fstream>
 #include <sstream>
+#include <limits>
+#include <algorithm>
 
 #include <Rcpp.h>
 
@@ -13,6 +15,14 @@
 using namespace Rcpp;
 using namespace std;
 
+// Non-negative R number (possibly Inf) as unsigned, saturating
+static unsigned asCount(double value) {
+    if (value >= numeric_limits<unsigned>::max()) {
+        return numeric_limits<unsigned>::max();
+    }
+    return (unsigned)max(value, 0.0);
+}
+
 //' @useDynLib metaRE
 //' @import Rcpp
 // [[Rcpp::export]]
@@ -45,6 +55,21 @@ SEXP enumerateMotifsCpp(List parameters, Function createGCS, Function logDebug)
         return R_NilValue;
     }
     factory.setCreateGCS(createGCS);
+    if (parameters.containsElementNamed("filter")) {
+        List filter = parameters["filter"];
+        factory.setGeneFilter(GeneFilter(
+            asCount(as<double>(filter["minGenes"])),
+            asCount(as<double>(filter["maxGenes"])),
+            asCount(as<double>(filter["topN"]))
+        ));
+    }
+    if (parameters.containsElementNamed("memoryBudget")) {
+        // Megabytes, Inf for no limit
+        double budget = as<double>(parameters["memoryBudget"]);
+        if (budget < numeric_limits<double>::infinity()) {
+            factory.setMemoryBudget((size_t)max(budget * (1 << 20), 1.0));
+        }
+    }
 
     List counterParams = parameters["counter"];
     auto counter = std::unique_ptr<IMotifCounter>(
@@ -61,6 +86,8 @@ SEXP enumerateMotifsCpp(List parameters, Function createGCS, Function logDebug)
     scanner.countMotifs(genes, geneIDs, geneNames);
     logDebug("Done. Creating structure...");
 
+    counter->getResult()->finalize();
+
     SEXP result = counter->getResult()->getSEXP();
     logDebug("Finished.");
     return result;
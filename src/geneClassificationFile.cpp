@@ -0,0 +1,40 @@
+#include <Rcpp.h>
+#include <memory>
+#include <numeric>
+#include "DataStructures/GeneClassificationFile.h"
+#include "DataStructures/MappedIntegers.h"
+#include "DataStructures/ElementLabels.h"
+using namespace Rcpp;
+
+// [[Rcpp::export]]
+void writeGeneClassificationCpp(IntegerVector offsets, IntegerVector genes,
+                                CharacterVector elementNames, CharacterVector geneNames,
+                                std::string path) {
+    GeneClassificationFile::write(path, offsets.begin(), genes.begin(),
+                                  as<std::vector<std::string> >(elementNames),
+                                  as<std::vector<std::string> >(geneNames));
+}
+
+// [[Rcpp::export]]
+List readGeneClassificationCpp(std::string path) {
+    // Vectors share the mapping, it is released with the last of them
+    std::shared_ptr<GeneClassificationFile> file = std::make_shared<GeneClassificationFile>(path);
+    unsigned elementCount = file->getElementCount();
+
+    List result = List::create(
+        Named("offsets") = makeMappedIntegers(file, file->getOffsets(), elementCount + 1),
+        Named("genes") = makeMappedIntegers(file, file->getGenes(), file->getGenesCount())
+    );
+
+    std::vector<unsigned> ids(elementCount);
+    std::iota(ids.begin(), ids.end(), 0);
+    result.attr("elementNames") = makeElementLabels(ids, [file](unsigned element) {
+        return file->getElementName(element);
+    });
+    CharacterVector geneNames(file->getGeneCount());
+    for (unsigned gene = 0; gene < file->getGeneCount(); gene++) {
+        geneNames[gene] = file->getGeneName(gene);
+    }
+    result.attr("geneNames") = geneNames;
+    return result;
+}
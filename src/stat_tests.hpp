@@ -1,10 +1,13 @@
+#ifndef STAT_TESTS_HPP_
+#define STAT_TESTS_HPP_
+
 #include <algorithm>
 #include <stdexcept>
 #include <boost/math/distributions/hypergeometric.hpp>
 
 enum class Alternative{LESS, GREATER, TWO_SIDED};
 
-Alternative strToAlternative(std::string val) {
+inline Alternative strToAlternative(std::string val) {
     if (!val.compare("two.sided")) {
         return Alternative::TWO_SIDED;
     } else if (!val.compare("less")) {
@@ -16,7 +19,7 @@ Alternative strToAlternative(std::string val) {
     }
 }
 
-int find_k(int left, int right, int sign, double value, boost::math::hypergeometric& hgd) {
+inline int find_k(int left, int right, int sign, double value, boost::math::hypergeometric& hgd) {
     if (right - left < 2) {
         double leftval = boost::math::pdf(hgd, left);
         double rightval = boost::math::pdf(hgd, right);
@@ -46,7 +49,7 @@ int find_k(int left, int right, int sign, double value, boost::math::hypergeomet
     }
 }
 
-double fisherTest(double eff1, double n1, double eff2, double n2, Alternative alternative){
+inline double fisherTest(double eff1, double n1, double eff2, double n2, Alternative alternative){
     int N = n1 + n2;
     int eff = eff1 + eff2;
 
@@ -89,3 +92,5 @@ double fisherTest(double eff1, double n1, double eff2, double n2, Alternative al
         throw std::invalid_argument("Illegal alternative");
     }
 }
+
+#endif /* STAT_TESTS_HPP_ */
@@ -0,0 +1,65 @@
+#include <testthat.h>
+#include <cmath>
+
+#include "../Stats/ApproximateTest.h"
+#include "../Stats/HypergeometricTable.h"
+
+static bool closeTo(double expected, double actual, double tolerance) {
+    return std::fabs(expected - actual) <= tolerance * std::fabs(expected);
+}
+
+context("ApproximateTest") {
+    test_that("only tables with large expected counts are approximated") {
+        ApproximateTest chiSquare(TestMethod::CHI_SQUARE, 100);
+        expect_true(chiSquare.method(300, 1000, 200, 1000) == TestMethod::CHI_SQUARE);
+        expect_true(chiSquare.method(10, 100, 200, 1900) == TestMethod::EXACT);
+        expect_true(chiSquare.method(0, 1000, 10, 1000) == TestMethod::EXACT);
+
+        ApproximateTest exact;
+        expect_true(exact.method(300, 1000, 200, 1000) == TestMethod::EXACT);
+        expect_error_as(ApproximateTest(TestMethod::G_TEST, 0), std::invalid_argument);
+    }
+
+    test_that("statistics match their definitions") {
+        ApproximateTest test(TestMethod::CHI_SQUARE, 1);
+        // a = 300, b = 700, c = 200, d = 800
+        double n = 2000, product = 1000. * 1000 * 500 * 1500;
+        double yates = std::fabs(300. * 800 - 700. * 200) - n / 2;
+        double chiSquare = n * yates * yates / product;
+        expect_true(closeTo(std::log(std::erfc(std::sqrt(chiSquare / 2))),
+                            test.logPvalue(TestMethod::CHI_SQUARE, 300, 1000, 200, 1000,
+                                           Alternative::TWO_SIDED), 1e-12));
+
+        double g = 2 * (300 * std::log(300 / 250.) + 700 * std::log(700 / 750.) +
+                        200 * std::log(200 / 250.) + 800 * std::log(800 / 750.));
+        expect_true(closeTo(std::log(0.5 * std::erfc(std::sqrt(g / 2))),
+                            test.logPvalue(TestMethod::G_TEST, 300, 1000, 200, 1000,
+                                           Alternative::GREATER), 1e-12));
+        expect_true(closeTo(std::log1p(-0.5 * std::erfc(std::sqrt(g / 2))),
+                            test.logPvalue(TestMethod::G_TEST, 300, 1000, 200, 1000,
+                                           Alternative::LESS), 1e-9));
+    }
+
+    test_that("approximations are close to the exact test for large tables") {
+        HypergeometricTable table(20000);
+        ApproximateTest test(TestMethod::CHI_SQUARE, 100);
+        for (TestMethod method : {TestMethod::CHI_SQUARE, TestMethod::G_TEST}) {
+            for (Alternative alternative : {Alternative::TWO_SIDED, Alternative::GREATER, Alternative::LESS}) {
+                for (unsigned eff1 : {900u, 1000u, 1100u}) {
+                    double exact = table.logFisherTest(eff1, 5000, 3000, 15000, alternative);
+                    double approximate = test.logPvalue(method, eff1, 5000, 3000, 15000, alternative);
+                    expect_true(std::fabs(exact - approximate) <= 0.05 * std::max(1., -exact));
+                }
+            }
+        }
+    }
+
+    test_that("normal tails don't underflow") {
+        expect_true(closeTo(std::log(0.5 * std::erfc(5 / std::sqrt(2.))),
+                            ApproximateTest::logUpperNormal(5), 1e-12));
+        expect_true(closeTo(ApproximateTest::logUpperNormal(30 - 1e-9),
+                            ApproximateTest::logUpperNormal(30), 1e-9));
+        double tail = ApproximateTest::logUpperNormal(100);
+        expect_true(std::isfinite(tail) && closeTo(-5000 - std::log(100.) - 0.918938533204673, tail, 1e-6));
+    }
+}
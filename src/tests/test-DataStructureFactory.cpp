@@ -3,7 +3,11 @@
 
 #include "../DataStructures/DataStructureFactory.h"
 #include "../DataStructures/ElementCounts.h"
+#include "../DataStructures/DenseElementCounts.h"
 #include "../DataStructures/MotifPositionsSparse.h"
+#include "../DataStructures/MotifPositionsCSR.h"
+#include "../DataStructures/GeneCountMatrix.h"
+#include "../DataStructures/MotifPositionsBitmap.h"
 
 context("DataStructureFactory") {
     test_that("initialization") {
@@ -30,9 +34,33 @@ context("DataStructureFactory") {
         expect_true(dynamic_cast<ElementCounts *>(data) != 0);
         delete data;
 
+        data = factory.create(labelGenerator, geneLabels, 256);
+        expect_true(dynamic_cast<DenseElementCounts *>(data) != 0);
+        delete data;
+
+        data = factory.create(labelGenerator, geneLabels,
+                              (uint64_t)DataStructureFactory::DENSE_ELEMENTS_LIMIT + 1);
+        expect_true(dynamic_cast<ElementCounts *>(data) != 0);
+        delete data;
+
         factory.setType(DataStructureFactory::type::MotifPositionsSparse);
         data = factory.create(labelGenerator, geneLabels);
         expect_true(dynamic_cast<MotifPositionsSparse *>(data) != 0);
         delete data;
+
+        expect_true(factory.setType("csr"));
+        data = factory.create(labelGenerator, geneLabels);
+        expect_true(dynamic_cast<MotifPositionsCSR *>(data) != 0);
+        delete data;
+
+        expect_true(factory.setType("bitmap"));
+        data = factory.create(labelGenerator, geneLabels);
+        expect_true(dynamic_cast<MotifPositionsBitmap *>(data) != 0);
+        delete data;
+
+        expect_true(factory.setType("matrix"));
+        data = factory.create(labelGenerator, geneLabels);
+        expect_true(dynamic_cast<GeneCountMatrix *>(data) != 0);
+        delete data;
     }
 }
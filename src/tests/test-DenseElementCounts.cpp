@@ -0,0 +1,56 @@
+#include <testthat.h>
+#include <iostream>
+
+#include "../DataStructures/DenseElementCounts.h"
+
+context("DenseElementCounts") {
+    test_that("initialization works") {
+        std::vector<std::string> elementLabels({"elem0", "elem1", "elem2"});
+        std::vector<std::string> geneLabels({"gene1", "gene2", "gene3", "gene4"});
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        DenseElementCounts data(labelGenerator, geneLabels, 4);
+
+        test_that("gene getters work") {
+            expect_true(data.getGeneCount() == geneLabels.size());
+
+            const std::vector<std::string> & dataGeneLabels = data.getGeneLabels();
+            for (unsigned i = 0; i < geneLabels.size(); i++) {
+                expect_true(data.getGeneLabel(i).compare(geneLabels[i]) == 0);
+                expect_true(dataGeneLabels[i].compare(geneLabels[i]) == 0);
+            }
+        };
+        test_that("structure getters work") {
+            data.sGeneInput(0);
+            data.sElementInput(0, 10);
+            data.sElementInput(2, 20);
+            data.sGeneInput(1);
+            data.sElementInput(0, 11);
+            data.sElementInput(0, 21);
+            data.sElementInput(0, 31);
+            data.sGeneInput(2);
+            data.sElementInput(0, 12);
+            data.sElementInput(2, 22);
+            data.sGeneInput(0);
+            data.sElementInput(0, 13);
+            data.sElementInput(2, 23);
+
+            const std::vector<uint32_t>& counts = data.getCounts();
+            expect_true(counts == std::vector<uint32_t>({6, 0, 3, 0}));
+
+            test_that("element getters work") {
+                expect_true(data.getElementCount() == 2);
+
+                auto dataElementLabels = data.getElementLabels();
+                expect_true(dataElementLabels.size() == 2);
+                expect_true(dataElementLabels.at(0).compare(elementLabels[0]) == 0);
+                expect_true(dataElementLabels.at(2).compare(elementLabels[2]) == 0);
+            };
+        };
+        test_that("IDs beyond the declared space are still counted") {
+            data.sElementInput(5, 0);
+            expect_true(data.getCounts().size() == 6);
+            expect_true(data.getCounts()[5] == 1);
+        };
+    };
+}
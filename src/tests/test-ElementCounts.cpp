@@ -53,4 +53,35 @@ context("ElementCounts") {
             };
         };
     };
+
+    test_that("spilling to disk gives the same result") {
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        std::vector<std::string> geneLabels({"gene1", "gene2", "gene3"});
+        ElementCounts spilled(labelGenerator, geneLabels), inMemory(labelGenerator, geneLabels);
+        spilled.setMemoryBudget(1);
+        for (unsigned gene = 0; gene < 4; gene++) {
+            for (auto * data : {&spilled, &inMemory}) {
+                data->sGeneInput(gene % 3);
+                for (unsigned i = 0; i < 10; i++) {
+                    data->sElementInput((i * 7 + gene) % 5, i);
+                }
+            }
+        }
+        spilled.finalize();
+        spilled.finalize();
+        inMemory.finalize();
+
+        expect_true(spilled.isSpilled());
+        expect_false(inMemory.isSpilled());
+        expect_true(spilled.getStructure().empty());
+        const auto& structure = inMemory.getStructure();
+        const auto& elements = spilled.getMergedElements();
+        expect_true(elements == std::vector<unsigned>({0, 1, 2, 3, 4}));
+        for (unsigned i = 0; i < elements.size(); i++) {
+            expect_true((int)spilled.getMergedCounts()[i] == structure.at(elements[i])[0]);
+        }
+        expect_true(spilled.getElementCount() == inMemory.getElementCount());
+        expect_true(spilled.getElementLabels() == inMemory.getElementLabels());
+    }
 }
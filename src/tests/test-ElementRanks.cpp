@@ -0,0 +1,22 @@
+#include <testthat.h>
+
+#include "../DataStructures/ElementRanks.h"
+
+context("ElementRanks") {
+    test_that("dense IDs are ranked") {
+        std::vector<unsigned> ids({5, 2, 5, 0, 2});
+        expect_true(rankIds(ids) == std::vector<unsigned>({0, 2, 5}));
+        expect_true(ids == std::vector<unsigned>({2, 1, 2, 0, 1}));
+    }
+
+    test_that("sparse IDs are ranked") {
+        std::vector<unsigned> ids({4000000000u, 7, 1000000, 7});
+        expect_true(rankIds(ids) == std::vector<unsigned>({7, 1000000, 4000000000u}));
+        expect_true(ids == std::vector<unsigned>({2, 0, 1, 0}));
+    }
+
+    test_that("no IDs give no ranks") {
+        std::vector<unsigned> ids;
+        expect_true(rankIds(ids).empty());
+    }
+}
@@ -0,0 +1,62 @@
+#include <testthat.h>
+
+#include "../Stats/FisherCache.h"
+
+context("FisherCache") {
+    HypergeometricTable table(100);
+
+    test_that("cached p-values match the table") {
+        FisherCache cache(table, Alternative::GREATER);
+        bool matches = true;
+        for (unsigned repeat = 0; repeat < 2; repeat++) {
+            for (unsigned elem = 0; elem <= 60; elem += 10) {
+                for (unsigned elemUp = 0; elemUp <= std::min(elem, 20u); elemUp++) {
+                    matches = matches &&
+                        cache.fisherTest(elemUp, elem, 20 - elemUp, 100 - elem) ==
+                        table.fisherTest(elemUp, elem, 20 - elemUp, 100 - elem, Alternative::GREATER);
+                }
+            }
+        }
+        expect_true(matches);
+        expect_true(cache.size() == 1 + 11 + 21 * 5);
+    }
+
+    test_that("tables with different margins are kept apart") {
+        FisherCache cache(table, Alternative::TWO_SIDED);
+        double first = cache.fisherTest(3, 10, 7, 90);
+        double second = cache.fisherTest(3, 10, 17, 80);
+        expect_true(first == table.fisherTest(3, 10, 7, 90, Alternative::TWO_SIDED));
+        expect_true(second == table.fisherTest(3, 10, 17, 80, Alternative::TWO_SIDED));
+        expect_true(cache.size() == 2);
+    }
+
+    test_that("cache stops growing at maxEntries") {
+        FisherCache cache(table, Alternative::LESS, 3);
+        for (unsigned elemUp = 0; elemUp < 10; elemUp++) {
+            expect_true(cache.fisherTest(elemUp, 10, 20, 90) ==
+                        table.fisherTest(elemUp, 10, 20, 90, Alternative::LESS));
+        }
+        expect_true(cache.size() == 3);
+    }
+
+    test_that("logarithmic caches return log p-values") {
+        FisherCache cache(table, Alternative::TWO_SIDED, FisherCache::DEFAULT_MAX_ENTRIES, true);
+        for (unsigned repeat = 0; repeat < 2; repeat++) {
+            expect_true(cache.fisherTest(3, 10, 7, 90) ==
+                        table.logFisherTest(3, 10, 7, 90, Alternative::TWO_SIDED));
+        }
+        expect_true(cache.size() == 1);
+    }
+
+    test_that("caches of all experiments share one budget") {
+        std::vector<FisherCache> caches =
+            FisherCache::forExperiments(table, Alternative::GREATER, 4, false, 8);
+        expect_true(caches.size() == 4);
+        for (FisherCache& cache : caches) {
+            for (unsigned elemUp = 0; elemUp < 10; elemUp++) {
+                cache.fisherTest(elemUp, 10, 20, 90);
+            }
+            expect_true(cache.size() == 2);
+        }
+    }
+}
@@ -0,0 +1,110 @@
+#include <testthat.h>
+#include <iostream>
+
+#include "../Motifs/FixedCompactMotifBuilder.hpp"
+#include "../Motifs/CompactMotifBuilder.h"
+#include "../Utils/Utils.h"
+
+context("FixedCompactMotifBuilder") {
+    test_that("single cell builder") {
+        unsigned size = 4;
+        FixedCompactMotifBuilder<1> builder(size);
+
+        test_that("builder is not ready until it's filled up") {
+            for (unsigned input = 1; input <= 2*size; input++) {
+                builder.put(1);
+                for (unsigned test = 1; test <= size; test++) {
+                    expect_true(builder.ready(test) == (test <= input));
+                }
+                expect_true(builder.ready() == (input >= size));
+            }
+        }
+
+        test_that("builder creates motifs") {
+            std::string sequence("acgtgct");
+            for (char c : sequence) {
+                builder.put(CHAR_TO_COMPACT(c));
+            }
+
+            std::string answer("tgct");
+            std::string complementAnswer("agca");
+            for (unsigned i = 1; i <= size; i++ ) {
+                expect_true(builder.ready(i));
+
+                std::unique_ptr<CompactMotif> motif(builder.build(i));
+                expect_true(answer.substr(size-i, i).compare(motif->getString()) == 0);
+
+                std::unique_ptr<CompactMotif> complement(builder.buildComplement(i));
+                expect_true(complementAnswer.substr(0, i).compare(complement->getString()) == 0);
+            }
+
+            cell buf = 0;
+            builder.write(&buf, 3);
+            expect_true(buf == 0x27);
+            expect_true(builder.getPos() == sequence.size());
+        }
+
+        test_that("skipping works") {
+            for (unsigned i = 0; i < size; i++) {
+                builder.put(0);
+            }
+            expect_true(builder.ready());
+            builder.skip();
+            for (unsigned j = 1; j <= size; j++) {
+                expect_false(builder.ready(j));
+            }
+            builder.put(1);
+            expect_true(builder.ready(1));
+            expect_false(builder.ready(2));
+        }
+
+        test_that("put IUPAC works as expected") {
+            builder.putIUPAC(1);
+            builder.putIUPAC(2);
+            builder.putIUPAC(4);
+            builder.putIUPAC(8);
+
+            std::unique_ptr<CompactMotif> motif(builder.build(4));
+            expect_true(motif->getString().compare("acgt")==0);
+
+            expect_error(builder.putIUPAC(3));
+        }
+    }
+
+    test_that("full cell is written completely") {
+        unsigned size = 32;
+        FixedCompactMotifBuilder<1> builder(size);
+        std::string sequence(size, 't');
+        for (char c : sequence) {
+            builder.put(CHAR_TO_COMPACT(c));
+        }
+        cell buf = 0;
+        builder.write(&buf);
+        expect_true(buf == ~(cell)0);
+    }
+
+    test_that("multi cell builder agrees with runtime builder") {
+        unsigned size = 40;
+        FixedCompactMotifBuilder<2> builder(size);
+        std::string sequence("acgtgctaacgtttgcatgcaagtcgatcgatcgtagctagctagctgatcga");
+        std::string rc = Utils::reverseComplement(sequence);
+        for (char c : sequence) {
+            builder.put(CHAR_TO_COMPACT(c));
+        }
+        for (unsigned i = 1; i <= size; i++) {
+            std::unique_ptr<CompactMotif> motif(builder.build(i));
+            CATCH_INFO("Motif: " << motif->getString());
+            expect_true(sequence.substr(sequence.size()-i, i).compare(motif->getString()) == 0);
+
+            std::unique_ptr<CompactMotif> complement(builder.buildComplement(i));
+            CATCH_INFO("Complement: " << complement->getString());
+            expect_true(rc.substr(0, i).compare(complement->getString()) == 0);
+        }
+    }
+
+    test_that("cell count must match motif length") {
+        expect_error(FixedCompactMotifBuilder<1>(33));
+        expect_error(FixedCompactMotifBuilder<2>(32));
+        expect_error(FixedCompactMotifBuilder<1>(0));
+    }
+}
@@ -0,0 +1,99 @@
+#include <testthat.h>
+#include <iostream>
+
+#include "../Motifs/FixedIUPACMotifBuilder.hpp"
+
+context("FixedIUPACMotifBuilder") {
+    test_that("single cell builder") {
+        unsigned size = 10;
+        FixedIUPACMotifBuilder<1> builder(size);
+
+        test_that("builder is not ready until it's filled up") {
+            for (unsigned input = 1; input <= 2*size; input++) {
+                builder.put(1);
+                for (unsigned test = 1; test <= size; test++) {
+                    expect_true(builder.ready(test) == (test <= input));
+                }
+                expect_true(builder.ready() == (input >= size));
+            }
+        }
+
+        test_that("builder creates motifs") {
+            std::string sequence("acgtrymkndbv-hsw");
+            for (char c : sequence) {
+                builder.put(CHAR_TO_IUPAC(c));
+            }
+
+            std::string answer("mkndbv-hsw");
+            std::string complementAnswer("wsd-bvhnmk");
+            for (unsigned i = 1; i <= size; i++ ) {
+                std::unique_ptr<IUPACMotif> motif(builder.build(i));
+                expect_true(answer.substr(size-i, i).compare(motif->getString()) == 0);
+
+                std::unique_ptr<IUPACMotif> complement(builder.buildComplement(i));
+                expect_true(complementAnswer.substr(0, i).compare(complement->getString()) == 0);
+            }
+        }
+
+        test_that("matching works") {
+            std::string sequence("acgtacgt");
+            for (char c : sequence) {
+                builder.putCompact(CHAR_TO_COMPACT(c));
+            }
+
+            IUPACMotif pattern("acgt");
+            expect_true(builder.matches(pattern));
+            IUPACMotif pattern2("NNSWDBRY");
+            expect_true(builder.matches(pattern2));
+            IUPACMotif pattern3("NNSWDBRV");
+            expect_false(builder.matches(pattern3));
+            IUPACMotif pattern4("acct");
+            expect_false(builder.matches(pattern4));
+            IUPACMotif pattern5("acgtac");
+            expect_false(builder.matches(pattern5));
+            expect_true(builder.matches(pattern5, true));
+        }
+    }
+
+    test_that("multi cell builder") {
+        unsigned size = 20;
+        FixedIUPACMotifBuilder<2> builder(size);
+        std::string sequence("ttacgtrymkndbv-hswacgtgc");
+        for (char c : sequence) {
+            builder.put(CHAR_TO_IUPAC(c));
+        }
+
+        test_that("motifs and complements span cells") {
+            for (unsigned i = 1; i <= size; i++) {
+                std::string answer = sequence.substr(sequence.size()-i, i);
+                std::unique_ptr<IUPACMotif> motif(builder.build(i));
+                CATCH_INFO("Motif: " << motif->getString());
+                expect_true(answer.compare(motif->getString()) == 0);
+
+                std::unique_ptr<Motif> rc(IUPACMotif(answer).getReverseComplement());
+                std::unique_ptr<IUPACMotif> complement(builder.buildComplement(i));
+                CATCH_INFO("Complement: " << complement->getString());
+                expect_true(rc->getString().compare(complement->getString()) == 0);
+            }
+        }
+
+        test_that("long patterns are matched on both strands") {
+            FixedIUPACMotifBuilder<2> compactBuilder(size);
+            std::string compactSequence("ttacgtgcaagtcgatcgtagc");
+            for (char c : compactSequence) {
+                compactBuilder.putCompact(CHAR_TO_COMPACT(c));
+            }
+            IUPACMotif pattern("nnwgcaagtcgatcgtagc");
+            expect_true(compactBuilder.matches(pattern));
+            IUPACMotif reverse("gctacgatcgacttgcwnn");
+            expect_false(compactBuilder.matches(reverse));
+            expect_true(compactBuilder.matches(reverse, true));
+            IUPACMotif mismatch("nnwgcaagtcgatcgtagg");
+            expect_false(compactBuilder.matches(mismatch, true));
+            expect_true(compactBuilder.matches(reverse, pattern));
+            expect_true(compactBuilder.matches(pattern, reverse));
+            std::unique_ptr<Motif> rcMismatch(mismatch.getReverseComplement());
+            expect_false(compactBuilder.matches(mismatch, *static_cast<IUPACMotif *>(rcMismatch.get())));
+        }
+    }
+}
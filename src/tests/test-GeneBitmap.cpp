@@ -0,0 +1,158 @@
+#include <testthat.h>
+#include <iostream>
+#include <cstring>
+#include <set>
+
+#include "../DataStructures/GeneBitmap.h"
+
+static GeneBitmap fromSet(const std::set<uint32_t>& genes) {
+    GeneBitmap bitmap;
+    for (uint32_t gene : genes) {
+        bitmap.add(gene);
+    }
+    return bitmap;
+}
+
+static void expect_same(const GeneBitmap& bitmap, const std::set<uint32_t>& genes) {
+    std::vector<uint32_t> expected(genes.begin(), genes.end());
+    expect_true(bitmap.toVector() == expected);
+    expect_true(bitmap.cardinality() == genes.size());
+}
+
+static uint32_t intersection(const std::set<uint32_t>& genes, const std::vector<uint32_t>& degs,
+                             uint32_t total) {
+    uint32_t result = 0;
+    for (uint32_t deg : degs) {
+        result += deg < total && genes.count(deg);
+    }
+    return result;
+}
+
+context("GeneBitmap") {
+    // Sparse genes, a dense block that turns into a bitmap and long runs
+    std::set<uint32_t> sparse({3, 70, 1000, 65535, 65536, 200000});
+    std::set<uint32_t> dense, runs;
+    for (uint32_t gene = 0; gene < 30000; gene += 3) {
+        dense.insert(gene);
+    }
+    for (uint32_t gene = 100; gene < 20000; gene++) {
+        if (gene % 1000 < 500) {
+            runs.insert(gene);
+        }
+    }
+    std::vector<std::set<uint32_t> > sets({sparse, dense, runs, std::set<uint32_t>()});
+
+    test_that("add and contains work") {
+        for (const auto& genes : sets) {
+            GeneBitmap bitmap = fromSet(genes);
+            expect_same(bitmap, genes);
+            for (uint32_t gene = 0; gene < 70000; gene += 7) {
+                expect_true(bitmap.contains(gene) == (genes.count(gene) > 0));
+            }
+        }
+    }
+
+    test_that("unordered and repeated adds work") {
+        GeneBitmap bitmap;
+        for (uint32_t gene : std::vector<uint32_t>({10, 5, 10, 70000, 5, 1})) {
+            bitmap.add(gene);
+        }
+        expect_same(bitmap, std::set<uint32_t>({1, 5, 10, 70000}));
+    }
+
+    test_that("runOptimize keeps the content") {
+        for (const auto& genes : sets) {
+            GeneBitmap bitmap = fromSet(genes);
+            bitmap.runOptimize();
+            expect_same(bitmap, genes);
+            for (uint32_t gene = 0; gene < 70000; gene += 7) {
+                expect_true(bitmap.contains(gene) == (genes.count(gene) > 0));
+            }
+            bitmap.add(150);
+            std::set<uint32_t> added(genes);
+            added.insert(150);
+            expect_same(bitmap, added);
+        }
+    }
+
+    test_that("union works for all container types") {
+        for (const auto& a : sets) {
+            for (const auto& b : sets) {
+                for (bool optimize : {false, true}) {
+                    GeneBitmap bitmap = fromSet(a), other = fromSet(b);
+                    if (optimize) {
+                        bitmap.runOptimize();
+                        other.runOptimize();
+                    }
+                    bitmap.unite(other);
+                    std::set<uint32_t> expected(a);
+                    expected.insert(b.begin(), b.end());
+                    expect_same(bitmap, expected);
+                }
+            }
+        }
+    }
+
+    test_that("intersection count works for all container types") {
+        std::vector<uint32_t> degs;
+        for (uint32_t gene = 0; gene < 70000; gene += 5) {
+            degs.push_back(gene);
+        }
+        degs.push_back(200000);
+        for (uint32_t total : {25000u, 70000u, 300000u}) {
+            std::vector<uint64_t> bitset = GeneBitmap::makeBitset(degs, total);
+            for (const auto& genes : sets) {
+                GeneBitmap bitmap = fromSet(genes);
+                expect_true(bitmap.intersectionCount(bitset) == intersection(genes, degs, total));
+                bitmap.runOptimize();
+                expect_true(bitmap.intersectionCount(bitset) == intersection(genes, degs, total));
+            }
+        }
+    }
+
+    test_that("serialization works") {
+        for (const auto& genes : sets) {
+            for (bool optimize : {false, true}) {
+                GeneBitmap bitmap = fromSet(genes);
+                if (optimize) {
+                    bitmap.runOptimize();
+                }
+                std::vector<uint8_t> bytes = bitmap.serialize();
+                GeneBitmap copy = GeneBitmap::deserialize(bytes.data(), bytes.size());
+                expect_same(copy, genes);
+            }
+        }
+        std::vector<uint8_t> bytes = fromSet(sparse).serialize();
+        expect_error(GeneBitmap::deserialize(bytes.data(), bytes.size() - 1));
+    }
+
+    test_that("corrupted containers are rejected") {
+        // key, type, cardinality, payload size, payload
+        auto container = [](uint8_t kind, uint32_t cardinality, uint32_t payload,
+                            const std::vector<uint16_t>& values) {
+            std::vector<uint8_t> bytes(11);
+            uint16_t key = 0;
+            std::memcpy(&bytes[0], &key, 2);
+            bytes[2] = kind;
+            std::memcpy(&bytes[3], &cardinality, 4);
+            std::memcpy(&bytes[7], &payload, 4);
+            const uint8_t * data = reinterpret_cast<const uint8_t *>(values.data());
+            bytes.insert(bytes.end(), data, data + values.size() * 2);
+            return bytes;
+        };
+        const uint8_t ARRAY = 0, RUN = 2;
+        std::vector<uint8_t> valid = container(RUN, 5, 2, {10, 4});
+        expect_true(GeneBitmap::deserialize(valid.data(), valid.size()).cardinality() == 5);
+
+        std::vector<std::vector<uint8_t> > corrupted = {
+            container(ARRAY, 1, 0xFFFFFFFF, {1}),
+            container(RUN, 5, 3, {10, 4, 20}),
+            container(RUN, 5, 4, {10, 4, 12, 0}),
+            container(ARRAY, 1000, 2, {1, 2}),
+            container(ARRAY, 2, 2, {2, 1})
+        };
+        for (const auto& bytes : corrupted) {
+            expect_error_as(GeneBitmap::deserialize(bytes.data(), bytes.size()), std::invalid_argument);
+        }
+    }
+}
@@ -0,0 +1,82 @@
+#include <testthat.h>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+
+#include "../DataStructures/GeneClassificationFile.h"
+
+static std::string tempPath(const std::string& name) {
+    for (const char * variable : {"TMPDIR", "TMP", "TEMP"}) {
+        const char * directory = std::getenv(variable);
+        if (directory && *directory) {
+            return std::string(directory) + "/" + name;
+        }
+    }
+    return "/tmp/" + name;
+}
+
+context("GeneClassificationFile") {
+    std::vector<int> offsets({0, 3, 5, 5});
+    std::vector<int> genes({1, 2, 4, 3, 4});
+    std::vector<std::string> elementNames({"AAAA | TTTT", "CCCC", "G"});
+    std::vector<std::string> geneNames({"gene1", "gene2", "", "gene4"});
+    std::string path = tempPath("test-GeneClassificationFile.bin");
+
+    test_that("written file is read back") {
+        GeneClassificationFile::write(path, offsets.data(), genes.data(), elementNames, geneNames);
+        GeneClassificationFile file(path);
+
+        expect_true(file.getElementCount() == 3);
+        expect_true(file.getGeneCount() == 4);
+        expect_true(file.getGenesCount() == 5);
+        expect_true(std::vector<int>(file.getOffsets(), file.getOffsets() + 4) == offsets);
+        expect_true(std::vector<int>(file.getGenes(), file.getGenes() + 5) == genes);
+        for (unsigned i = 0; i < elementNames.size(); i++) {
+            expect_true(file.getElementName(i) == elementNames[i]);
+        }
+        for (unsigned i = 0; i < geneNames.size(); i++) {
+            expect_true(file.getGeneName(i) == geneNames[i]);
+        }
+    }
+
+    test_that("changes in memory do not reach the file") {
+        GeneClassificationFile::write(path, offsets.data(), genes.data(), elementNames, geneNames);
+        {
+            GeneClassificationFile file(path);
+            file.getGenes()[0] = 42;
+        }
+        GeneClassificationFile file(path);
+        expect_true(file.getGenes()[0] == 1);
+    }
+
+    test_that("malformed files are rejected") {
+        expect_error(GeneClassificationFile{path + ".missing"});
+
+        std::ofstream(path, std::ios::binary) << "not a gene classification file at all";
+        expect_error(GeneClassificationFile{path});
+
+        GeneClassificationFile::write(path, offsets.data(), genes.data(), elementNames, geneNames);
+        std::string content;
+        {
+            std::ifstream in(path, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        }
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << content.substr(0, content.size() - 1);
+        expect_error(GeneClassificationFile{path});
+    }
+
+    test_that("corrupt offsets and genes are rejected") {
+        std::vector<int> decreasing({0, 4, 3, 5});
+        GeneClassificationFile::write(path, decreasing.data(), genes.data(), elementNames, geneNames);
+        expect_error_as(GeneClassificationFile{path}, std::runtime_error);
+
+        for (int gene : {0, 5}) {
+            std::vector<int> outOfRange(genes);
+            outOfRange[2] = gene;
+            GeneClassificationFile::write(path, offsets.data(), outOfRange.data(), elementNames, geneNames);
+            expect_error_as(GeneClassificationFile{path}, std::runtime_error);
+        }
+    }
+
+    std::remove(path.c_str());
+}
@@ -0,0 +1,111 @@
+#include <testthat.h>
+#include <iostream>
+
+#include "../DataStructures/GeneCountMatrix.h"
+
+context("GeneCountMatrix") {
+    test_that("initialization works") {
+        std::vector<std::string> elementLabels({"elem0", "elem1", "elem2"});
+        std::vector<std::string> geneLabels({"gene1", "gene2", "gene3", "gene4"});
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        GeneCountMatrix data(labelGenerator, geneLabels);
+
+        test_that("gene getters work") {
+            expect_true(data.getGeneCount() == geneLabels.size());
+
+            const std::vector<std::string> & dataGeneLabels = data.getGeneLabels();
+            for (unsigned i = 0; i < geneLabels.size(); i++) {
+                expect_true(data.getGeneLabel(i).compare(geneLabels[i]) == 0);
+                expect_true(dataGeneLabels[i].compare(geneLabels[i]) == 0);
+            }
+        };
+        test_that("structure getters work") {
+            data.sGeneInput(2);
+            data.sElementInput(0, 12);
+            data.sElementInput(1, 22);
+            data.sGeneInput(0);
+            data.sElementInput(2, 10);
+            data.sElementInput(0, 10);
+            data.sElementInput(1, 20);
+            data.sGeneInput(1);
+            data.sElementInput(0, 11);
+            data.sElementInput(0, 21);
+            data.sElementInput(0, 31);
+            data.sGeneInput(2);
+            data.sElementInput(1, 32);
+            data.sGeneInput(0);
+            data.sElementInput(0, 13);
+            data.sElementInput(1, 23);
+            data.finalize();
+            data.finalize();
+
+            expect_true(data.getElements() == std::vector<unsigned>({0, 1, 2}));
+            expect_true(data.getOffsets() == std::vector<unsigned>({0, 3, 5, 6}));
+            expect_true(data.getGenes() == std::vector<unsigned>({0, 1, 2, 0, 2, 0}));
+            expect_true(data.getCounts() == std::vector<unsigned>({2, 3, 1, 2, 2, 1}));
+
+            test_that("element getters work") {
+                expect_true(data.getElementCount() == elementLabels.size());
+
+                auto dataElementLabels = data.getElementLabels();
+                for (unsigned i = 0; i < elementLabels.size(); i++) {
+                    expect_true(data.getElementLabel(i).compare(elementLabels[i]) == 0);
+                    expect_true(dataElementLabels.at(i).compare(elementLabels[i]) == 0);
+                }
+            };
+        };
+    };
+
+    test_that("sparse element IDs are ranked") {
+        std::vector<std::string> geneLabels({"gene1", "gene2"});
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        GeneCountMatrix data(labelGenerator, geneLabels);
+        data.sGeneInput(0);
+        data.sElementInput(1000000, 0);
+        data.sElementInput(7, 0);
+        data.sElementInput(1000000, 0);
+        data.sGeneInput(1);
+        data.sElementInput(1000000, 0);
+        data.finalize();
+
+        expect_true(data.getElements() == std::vector<unsigned>({7, 1000000}));
+        expect_true(data.getOffsets() == std::vector<unsigned>({0, 1, 3}));
+        expect_true(data.getGenes() == std::vector<unsigned>({0, 0, 1}));
+        expect_true(data.getCounts() == std::vector<unsigned>({1, 2, 1}));
+    }
+
+    test_that("empty structure works") {
+        GeneCountMatrix data([](unsigned id){return std::to_string(id);},
+                             std::vector<std::string>({"gene1"}));
+        data.sGeneInput(0);
+        data.finalize();
+        expect_true(data.getElementCount() == 0);
+        expect_true(data.getOffsets() == std::vector<unsigned>({0}));
+    }
+
+    test_that("gene filter drops elements before output") {
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        GeneCountMatrix data(labelGenerator, std::vector<std::string>({"gene1", "gene2", "gene3"}));
+        data.setGeneFilter(GeneFilter(2, 2));
+        data.sGeneInput(0);
+        data.sElementInput(0, 10);
+        data.sElementInput(1, 20);
+        data.sGeneInput(1);
+        data.sElementInput(0, 11);
+        data.sElementInput(2, 21);
+        data.sElementInput(2, 31);
+        data.sGeneInput(2);
+        data.sElementInput(0, 12);
+        data.sElementInput(1, 22);
+        data.sElementInput(1, 32);
+        data.finalize();
+
+        expect_true(data.getElements() == std::vector<unsigned>({1}));
+        expect_true(data.getOffsets() == std::vector<unsigned>({0, 2}));
+        expect_true(data.getGenes() == std::vector<unsigned>({0, 2}));
+        expect_true(data.getCounts() == std::vector<unsigned>({1, 2}));
+    }
+}
@@ -0,0 +1,49 @@
+#include <testthat.h>
+
+#include "../DataStructures/GeneFilter.h"
+
+context("GeneFilter") {
+    std::vector<unsigned> ids({10, 3, 7, 5, 1});
+    std::vector<unsigned> support({1, 4, 2, 4, 3});
+
+    test_that("default filter keeps everything") {
+        GeneFilter filter;
+        expect_false(filter.isActive());
+        auto keep = filter.select(ids, support);
+        expect_true(keep == std::vector<bool>(5, true));
+    }
+
+    test_that("gene thresholds work") {
+        GeneFilter filter(2, 3);
+        expect_true(filter.isActive());
+        auto keep = filter.select(ids, support);
+        expect_true(keep == std::vector<bool>({false, false, true, false, true}));
+    }
+
+    test_that("topN keeps best supported elements, ties go to smaller IDs") {
+        auto keep = GeneFilter(1, 10, 1).select(ids, support);
+        expect_true(keep == std::vector<bool>({false, true, false, false, false}));
+
+        keep = GeneFilter(1, 10, 3).select(ids, support);
+        expect_true(keep == std::vector<bool>({false, true, false, true, true}));
+
+        keep = GeneFilter(1, 3, 2).select(ids, support);
+        expect_true(keep == std::vector<bool>({false, false, true, false, true}));
+
+        keep = GeneFilter(1, 10, 0).select(ids, support);
+        expect_true(keep == std::vector<bool>(5, false));
+    }
+
+    test_that("elements stored by offsets are compacted") {
+        // Elements 7, 3 and 9 with 1, 3 and 2 rows
+        std::vector<unsigned> elements({7, 3, 9}), offsets({0, 1, 4, 6});
+        std::vector<unsigned> genes({0, 1, 2, 3, 4, 5});
+        std::vector<int> counts({10, 11, 12, 13, 14, 15});
+        expect_true(GeneFilter::rowCounts(offsets) == std::vector<unsigned>({1, 3, 2}));
+        GeneFilter(2).compact(elements, offsets, GeneFilter::rowCounts(offsets), genes, counts);
+        expect_true(elements == std::vector<unsigned>({3, 9}));
+        expect_true(offsets == std::vector<unsigned>({0, 3, 5}));
+        expect_true(genes == std::vector<unsigned>({1, 2, 3, 4, 5}));
+        expect_true(counts == std::vector<int>({11, 12, 13, 14, 15}));
+    }
+}
@@ -0,0 +1,126 @@
+#include <testthat.h>
+#include <cmath>
+#include <random>
+
+#include "../Stats/HypergeometricTable.h"
+
+static bool closeTo(double expected, double actual) {
+    return std::fabs(expected - actual) <= 1e-7 * expected + 1e-300;
+}
+
+context("HypergeometricTable") {
+    test_that("p-values match fisherTest") {
+        const unsigned totalGenes = 300;
+        HypergeometricTable table(totalGenes);
+        expect_true(table.covers(totalGenes));
+
+        std::mt19937 generator(17);
+        bool matches = true;
+        for (unsigned i = 0; i < 3000; i++) {
+            unsigned n1 = generator() % (totalGenes + 1);
+            unsigned n2 = totalGenes - n1;
+            unsigned eff1 = generator() % (n1 + 1);
+            unsigned eff2 = generator() % (n2 + 1);
+            for (Alternative alternative : {Alternative::TWO_SIDED, Alternative::GREATER, Alternative::LESS}) {
+                matches = matches && closeTo(fisherTest(eff1, n1, eff2, n2, alternative),
+                                             table.fisherTest(eff1, n1, eff2, n2, alternative));
+            }
+        }
+        expect_true(matches);
+    }
+
+    test_that("symmetric tables and margins work") {
+        HypergeometricTable table(40);
+        for (Alternative alternative : {Alternative::TWO_SIDED, Alternative::GREATER, Alternative::LESS}) {
+            expect_true(closeTo(fisherTest(5, 20, 15, 20, alternative),
+                                table.fisherTest(5, 20, 15, 20, alternative)));
+            expect_true(closeTo(fisherTest(10, 20, 10, 20, alternative),
+                                table.fisherTest(10, 20, 10, 20, alternative)));
+            expect_true(closeTo(fisherTest(0, 20, 7, 20, alternative),
+                                table.fisherTest(0, 20, 7, 20, alternative)));
+            expect_true(closeTo(fisherTest(20, 20, 0, 20, alternative),
+                                table.fisherTest(20, 20, 0, 20, alternative)));
+            expect_true(closeTo(fisherTest(0, 0, 3, 40, alternative),
+                                table.fisherTest(0, 0, 3, 40, alternative)));
+        }
+        expect_true(closeTo(1, table.fisherTest(10, 20, 10, 20, Alternative::TWO_SIDED)));
+    }
+
+    test_that("tiny p-values fall back to fisherTest") {
+        HypergeometricTable table(4000);
+        expect_true(table.fisherTest(2000, 2000, 0, 2000, Alternative::GREATER) ==
+                    fisherTest(2000, 2000, 0, 2000, Alternative::GREATER));
+        expect_true(closeTo(fisherTest(200, 2000, 100, 2000, Alternative::TWO_SIDED),
+                            table.fisherTest(200, 2000, 100, 2000, Alternative::TWO_SIDED)));
+    }
+
+    test_that("large tables fall back to fisherTest") {
+        HypergeometricTable table(100);
+        expect_false(table.covers(101));
+        expect_true(table.fisherTest(30, 100, 10, 100, Alternative::TWO_SIDED) ==
+                    fisherTest(30, 100, 10, 100, Alternative::TWO_SIDED));
+
+        HypergeometricTable huge(100000000);
+        expect_false(huge.covers(100000000));
+    }
+
+    test_that("log p-values match p-values") {
+        const unsigned totalGenes = 300;
+        HypergeometricTable table(totalGenes);
+        std::mt19937 generator(23);
+        bool matches = true;
+        for (unsigned i = 0; i < 3000; i++) {
+            unsigned n1 = generator() % (totalGenes + 1);
+            unsigned n2 = totalGenes - n1;
+            unsigned eff1 = generator() % (n1 + 1);
+            unsigned eff2 = generator() % (n2 + 1);
+            for (Alternative alternative : {Alternative::TWO_SIDED, Alternative::GREATER, Alternative::LESS}) {
+                double pvalue = table.fisherTest(eff1, n1, eff2, n2, alternative);
+                double logPvalue = table.logFisherTest(eff1, n1, eff2, n2, alternative);
+                matches = matches && logPvalue <= 0 &&
+                    std::fabs(std::log(pvalue) - logPvalue) <= 1e-7 * std::max(1., -logPvalue);
+            }
+        }
+        expect_true(matches);
+    }
+
+    test_that("log p-values don't underflow") {
+        HypergeometricTable table(4000);
+        // The only table as extreme: all up genes belong to the element
+        double expected = std::lgamma(2001.) * 2 - std::lgamma(4001.);
+        double logPvalue = table.logFisherTest(2000, 2000, 0, 2000, Alternative::GREATER);
+        expect_true(std::fabs(logPvalue - expected) <= 1e-9 * -expected);
+        expect_true(std::fabs(table.logFisherTest(2000, 2000, 0, 2000, Alternative::TWO_SIDED) -
+                              (expected + std::log(2.))) <= 1e-9 * -expected);
+        expect_true(table.logFisherTest(2000, 2000, 0, 2000, Alternative::LESS) == 0);
+    }
+
+    test_that("p-value bounds don't exceed log p-values") {
+        const unsigned totalGenes = 300;
+        HypergeometricTable table(totalGenes);
+        std::mt19937 generator(29);
+        bool bounded = true;
+        for (unsigned i = 0; i < 3000; i++) {
+            unsigned n1 = generator() % (totalGenes + 1);
+            unsigned n2 = totalGenes - n1;
+            unsigned eff1 = generator() % (n1 + 1);
+            unsigned eff2 = generator() % (n2 + 1);
+            for (Alternative alternative : {Alternative::TWO_SIDED, Alternative::GREATER, Alternative::LESS}) {
+                bounded = bounded && table.logPvalueBound(eff1, n1, eff2, n2, alternative) <=
+                    table.logFisherTest(eff1, n1, eff2, n2, alternative) + 1e-9;
+            }
+        }
+        expect_true(bounded);
+
+        // 5000 of 20000 genes are up, an element with 1000 genes expects 250
+        HypergeometricTable wide(20000);
+        expect_true(wide.logPvalueBound(250, 5000, 750, 15000, Alternative::GREATER) == std::log(0.5));
+        expect_true(wide.logPvalueBound(250, 5000, 750, 15000, Alternative::LESS) == std::log(0.5));
+        expect_true(wide.logPvalueBound(240, 5000, 760, 15000, Alternative::LESS) < std::log(0.5));
+        expect_true(wide.logFisherTest(250, 5000, 750, 15000, Alternative::GREATER) >= std::log(0.5));
+        expect_true(wide.logPvalueBound(0, 0, 0, 0, Alternative::GREATER) == 0);
+
+        HypergeometricTable small(100);
+        expect_true(std::isinf(small.logPvalueBound(30, 100, 10, 100, Alternative::TWO_SIDED)));
+    }
+}
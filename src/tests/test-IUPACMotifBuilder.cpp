@@ -102,6 +102,11 @@ context("IUPACMotif") {
             IUPACMotif pattern5("acgtac");
             expect_false(builder.matches(pattern5));
             expect_true(builder.matches(pattern5, true));
+
+            std::unique_ptr<Motif> rcPattern5(pattern5.getReverseComplement());
+            expect_true(builder.matches(pattern5, *static_cast<IUPACMotif *>(rcPattern5.get())));
+            std::unique_ptr<Motif> rcPattern4(pattern4.getReverseComplement());
+            expect_false(builder.matches(pattern4, *static_cast<IUPACMotif *>(rcPattern4.get())));
         }
 
         // TODO test the rest of the functions
@@ -0,0 +1,61 @@
+#include <testthat.h>
+#include <iostream>
+
+#include "../Pattern/KmerSetPattern.h"
+#include "../Pattern/Pattern.h"
+#include "../Pattern/PatternWrongSizeException.hpp"
+#include "../Utils/Utils.h"
+
+context("KmerSetPattern") {
+    test_that("agrees with Pattern") {
+        unsigned k = 5;
+        std::string p = "ACANB";
+        KmerSetPattern pattern(p);
+        Pattern reference(p);
+        for (unsigned kmer = 0; kmer < Utils::getKmersTotal(k); kmer++) {
+            expect_true(pattern.check(kmer, k) == reference.check(kmer));
+        }
+        std::vector<unsigned> kmers = reference.getKmers();
+        const std::vector<uint64_t>& setKmers = pattern.getKmers(k);
+        expect_true(std::equal(kmers.begin(), kmers.end(), setKmers.begin()));
+        expect_true(pattern.size() == 12);
+    }
+
+    test_that("patterns of different lengths are kept apart") {
+        KmerSetPattern pattern("ACG");
+        pattern.add("wa");
+        pattern.add("ACG");
+        expect_true(pattern.size() == 3);
+        expect_true(pattern.getLengths() == std::vector<unsigned>({2, 3}));
+        expect_true(pattern.check(Utils::stringToInt("ACG"), 3));
+        expect_false(pattern.check(Utils::stringToInt("ACG"), 2));
+        expect_true(pattern.check(Utils::stringToInt("TA"), 2));
+        expect_false(pattern.check(Utils::stringToInt("TA"), 3));
+        expect_true(pattern.getKmers(4).empty());
+    }
+
+    test_that("added kmers stay sorted") {
+        KmerSetPattern pattern("TNA");
+        pattern.add("ANT");
+        const std::vector<uint64_t>& kmers = pattern.getKmers(3);
+        expect_true(kmers.size() == 8);
+        expect_true(std::is_sorted(kmers.begin(), kmers.end()));
+    }
+
+    test_that("32-mers work") {
+        std::string p(32, 'T');
+        p[0] = 'N';
+        KmerSetPattern pattern(p);
+        expect_true(pattern.size() == 4);
+        uint64_t allT = ~(uint64_t)0;
+        expect_true(pattern.check(allT, 32));
+        expect_true(pattern.check(allT >> 2, 32));
+        expect_false(pattern.check(allT >> 2, 31));
+    }
+
+    test_that("wrong sizes throw exception") {
+        KmerSetPattern pattern;
+        expect_error_as(pattern.add(""), PatternWrongSizeException);
+        expect_error_as(pattern.add(std::string(33, 'A')), PatternWrongSizeException);
+    }
+}
@@ -0,0 +1,143 @@
+#include <testthat.h>
+#include <cmath>
+#include <random>
+#include <stdexcept>
+
+#include "../Stats/MassFisherTest.h"
+
+context("MassFisherTest") {
+    const unsigned genes = 500, experiments = 3, elements = 1000;
+    std::vector<unsigned> sums({40, 100, 250});
+    std::mt19937 generator(11);
+    std::vector<std::vector<unsigned> > up(elements, std::vector<unsigned>(experiments));
+    std::vector<unsigned> sizes(elements);
+    for (unsigned element = 0; element < elements; element++) {
+        sizes[element] = generator() % 60;
+        for (unsigned experiment = 0; experiment < experiments; experiment++) {
+            up[element][experiment] = generator() % (std::min(sizes[element], sums[experiment]) + 1);
+        }
+    }
+    MassFisherTest::Counter counter = [&](unsigned element, unsigned * counts) {
+        std::copy(up[element].begin(), up[element].end(), counts);
+        return sizes[element];
+    };
+    MassFisherTest test(genes, sums, Alternative::TWO_SIDED);
+
+    test_that("serial run matches single tests") {
+        std::vector<double> result(elements * experiments);
+        test.run(elements, counter, result.data());
+        HypergeometricTable table(genes);
+        bool matches = true;
+        for (unsigned element = 0; element < elements; element++) {
+            for (unsigned experiment = 0; experiment < experiments; experiment++) {
+                unsigned elemUp = up[element][experiment];
+                matches = matches && result[element + experiment * elements] ==
+                    table.fisherTest(elemUp, sizes[element], sums[experiment] - elemUp,
+                                     genes - sizes[element], Alternative::TWO_SIDED);
+            }
+        }
+        expect_true(matches);
+    }
+
+    test_that("parallel runs are identical to the serial one") {
+        std::vector<double> serial(elements * experiments), parallel(elements * experiments);
+        test.run(elements, counter, serial.data(), 1);
+        for (unsigned threads : {2u, 4u, 16u}) {
+            std::fill(parallel.begin(), parallel.end(), -1);
+            test.run(elements, counter, parallel.data(), threads);
+            expect_true(serial == parallel);
+        }
+    }
+
+    test_that("log p-values match single tests") {
+        MassFisherTest logTest(genes, sums, Alternative::TWO_SIDED, true);
+        std::vector<double> result(elements * experiments);
+        logTest.run(elements, counter, result.data());
+        HypergeometricTable table(genes);
+        bool matches = true;
+        for (unsigned element = 0; element < elements; element++) {
+            for (unsigned experiment = 0; experiment < experiments; experiment++) {
+                unsigned elemUp = up[element][experiment];
+                matches = matches && result[element + experiment * elements] ==
+                    table.logFisherTest(elemUp, sizes[element], sums[experiment] - elemUp,
+                                        genes - sizes[element], Alternative::TWO_SIDED);
+            }
+        }
+        expect_true(matches);
+    }
+
+    test_that("sum of logs matches the log p-value matrix") {
+        MassFisherTest logTest(genes, sums, Alternative::TWO_SIDED, true);
+        std::vector<double> result(elements * experiments);
+        logTest.run(elements, counter, result.data());
+        std::vector<double> expected(elements, 0.);
+        for (unsigned experiment = 0; experiment < experiments; experiment++) {
+            for (unsigned element = 0; element < elements; element++) {
+                expected[element] += MassFisherTest::logSumlogTerm(result[element + experiment * elements]);
+            }
+        }
+        const size_t expectedZeros = 0;
+        std::vector<double> statistics(elements, -1);
+        for (unsigned threads : {1u, 4u}) {
+            expect_true(test.runSumlog(elements, counter, statistics.data(), threads) == expectedZeros);
+            expect_true(statistics == expected);
+        }
+    }
+
+    test_that("pruned cells can't reach the cutoff") {
+        MassFisherTest greater(genes, sums, Alternative::GREATER);
+        std::vector<double> full(elements * experiments), pruned(elements * experiments);
+        greater.run(elements, counter, full.data());
+        greater.run(elements, counter, pruned.data(), 4, 0.01);
+        bool consistent = true;
+        unsigned prunedCells = 0;
+        for (size_t cell = 0; cell < full.size(); cell++) {
+            if (std::isnan(pruned[cell])) {
+                prunedCells++;
+                consistent = consistent && full[cell] > 0.01;
+            } else {
+                consistent = consistent && pruned[cell] == full[cell];
+            }
+        }
+        expect_true(consistent);
+        expect_true(prunedCells > 0);
+    }
+
+    test_that("approximated cells and their methods are reported") {
+        ApproximateTest approximation(TestMethod::G_TEST, 10);
+        MassFisherTest adaptive(genes, sums, Alternative::TWO_SIDED, false, approximation);
+        std::vector<double> result(elements * experiments);
+        std::vector<TestMethod> methods(elements * experiments);
+        adaptive.run(elements, counter, result.data(), 4, 1, methods.data());
+        HypergeometricTable table(genes);
+        bool matches = true;
+        unsigned approximated = 0;
+        for (unsigned element = 0; element < elements; element++) {
+            for (unsigned experiment = 0; experiment < experiments; experiment++) {
+                size_t cell = element + experiment * elements;
+                unsigned elemUp = up[element][experiment];
+                unsigned restUp = sums[experiment] - elemUp, rest = genes - sizes[element];
+                TestMethod method = approximation.method(elemUp, sizes[element], restUp, rest);
+                double expected = method == TestMethod::EXACT ?
+                    table.fisherTest(elemUp, sizes[element], restUp, rest, Alternative::TWO_SIDED) :
+                    std::exp(approximation.logPvalue(method, elemUp, sizes[element], restUp, rest,
+                                                     Alternative::TWO_SIDED));
+                approximated += method != TestMethod::EXACT;
+                matches = matches && methods[cell] == method && result[cell] == expected;
+            }
+        }
+        expect_true(matches);
+        expect_true(approximated > 0 && approximated < elements * experiments);
+    }
+
+    test_that("worker errors reach the caller") {
+        std::vector<double> result(elements * experiments);
+        MassFisherTest::Counter failing = [&](unsigned element, unsigned * counts) -> unsigned {
+            if (element == elements - 1) {
+                throw std::runtime_error("counter failed");
+            }
+            return counter(element, counts);
+        };
+        expect_error_as(test.run(elements, failing, result.data(), 4), std::runtime_error);
+    }
+}
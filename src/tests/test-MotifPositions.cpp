@@ -35,31 +35,15 @@ context("MotifPositions") {
             data.sElementInput(0, 13);
             data.sElementInput(1, 23);
 
-            const auto structure = data.getPositions();
-            expect_true(structure.size() == 2);
+            data.finalize();
 
-            expect_true(structure.at(0).size() == 3);
-
-            expect_true(structure.at(0).at(0).size() == 2);
-            expect_true(structure.at(0).at(0)[0] == 10);
-            expect_true(structure.at(0).at(0)[1] == 13);
-
-            expect_true(structure.at(0).at(1).size() == 3);
-            expect_true(structure.at(0).at(1)[0] == 11);
-            expect_true(structure.at(0).at(1)[1] == 21);
-            expect_true(structure.at(0).at(1)[2] == 31);
-
-            expect_true(structure.at(0).at(2).size() == 1);
-            expect_true(structure.at(0).at(2)[0] == 12);
-
-            expect_true(structure.at(1).size() == 2);
-
-            expect_true(structure.at(1).at(0).size() == 2);
-            expect_true(structure.at(1).at(0)[0] == 20);
-            expect_true(structure.at(1).at(0)[1] == 23);
-
-            expect_true(structure.at(1).at(2).size() == 1);
-            expect_true(structure.at(1).at(2)[0] == 22);
+            expect_true(data.getElementOffsets() == std::vector<unsigned>({0, 6, 9}));
+            expect_true(data.getElements() ==
+                        std::vector<unsigned>({0, 0, 0, 0, 0, 0, 1, 1, 1}));
+            expect_true(data.getGenes() ==
+                        std::vector<unsigned>({0, 0, 1, 1, 1, 2, 0, 0, 2}));
+            expect_true(data.getPositions() ==
+                        std::vector<int>({10, 13, 11, 21, 31, 12, 20, 23, 22}));
 
             test_that("element getters work") {
                 expect_true(data.getElementCount() == elementLabels.size());
@@ -72,4 +56,52 @@ context("MotifPositions") {
             };
         };
     };
+
+    test_that("gene filter drops elements before output") {
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        MotifPositions data(labelGenerator, std::vector<std::string>({"gene1", "gene2", "gene3"}));
+        data.setGeneFilter(GeneFilter(2, 2));
+        data.sGeneInput(0);
+        data.sElementInput(0, 10);
+        data.sElementInput(1, 20);
+        data.sGeneInput(1);
+        data.sElementInput(0, 11);
+        data.sElementInput(2, 21);
+        data.sElementInput(2, 31);
+        data.sGeneInput(2);
+        data.sElementInput(0, 12);
+        data.sElementInput(1, 22);
+        data.sElementInput(1, 32);
+        data.finalize();
+
+        expect_true(data.getElementOffsets() == std::vector<unsigned>({0, 3}));
+        expect_true(data.getElements() == std::vector<unsigned>({1, 1, 1}));
+        expect_true(data.getGenes() == std::vector<unsigned>({0, 2, 2}));
+        expect_true(data.getPositions() == std::vector<int>({20, 22, 32}));
+    }
+
+    test_that("memory budget does not change the result") {
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        std::vector<std::string> geneLabels({"gene1", "gene2", "gene3"});
+        MotifPositions limited(labelGenerator, geneLabels), inMemory(labelGenerator, geneLabels);
+        limited.setMemoryBudget(1);
+        for (unsigned gene = 0; gene < 4; gene++) {
+            for (auto * data : {&limited, &inMemory}) {
+                data->sGeneInput(gene % 3);
+                for (unsigned i = 0; i < 10; i++) {
+                    data->sElementInput((i * 7 + gene) % 5, i);
+                }
+            }
+        }
+        limited.finalize();
+        limited.finalize();
+        inMemory.finalize();
+
+        expect_true(limited.getElementOffsets() == inMemory.getElementOffsets());
+        expect_true(limited.getElements() == inMemory.getElements());
+        expect_true(limited.getGenes() == inMemory.getGenes());
+        expect_true(limited.getPositions() == inMemory.getPositions());
+    }
 }
@@ -0,0 +1,61 @@
+#include <testthat.h>
+#include <random>
+
+#include "../Stats/PackedExperiments.h"
+
+context("PackedExperiments") {
+    const unsigned genes = 1000, experiments = 5;
+    std::mt19937 generator(5);
+    std::vector<std::vector<bool> > up(experiments, std::vector<bool>(genes));
+    PackedExperiments packed(genes, experiments);
+    for (unsigned experiment = 0; experiment < experiments; experiment++) {
+        for (unsigned gene = 0; gene < genes; gene++) {
+            if (generator() % 3 == 0) {
+                up[experiment][gene] = true;
+                packed.set(gene, experiment);
+            }
+        }
+    }
+
+    test_that("packing works") {
+        expect_true(packed.getGeneCount() == genes);
+        expect_true(packed.getExperimentCount() == experiments);
+        expect_true(packed.getColumn(0).size() == 16);
+    }
+
+    test_that("sparse and dense elements are counted") {
+        for (unsigned size : {0u, 3u, 31u, 32u, 500u, 1000u}) {
+            std::vector<int> element;
+            GeneBitmap bitmap;
+            for (unsigned gene = 0; gene < genes && element.size() < size; gene += genes / std::max(size, 1u)) {
+                element.push_back(gene + 1);
+                bitmap.add(gene);
+            }
+            std::vector<unsigned> counts(experiments), bitmapCounts(experiments), expected(experiments, 0);
+            for (unsigned experiment = 0; experiment < experiments; experiment++) {
+                for (int gene : element) {
+                    expected[experiment] += up[experiment][gene - 1];
+                }
+            }
+            packed.countUp(element.data(), element.size(), counts.data());
+            packed.countUp(bitmap, bitmapCounts.data());
+            expect_true(counts == expected);
+            expect_true(bitmapCounts == expected);
+        }
+    }
+
+    test_that("popcount kernels agree") {
+        std::vector<uint64_t> a(37), b(37);
+        for (size_t word = 0; word < a.size(); word++) {
+            a[word] = ((uint64_t)generator() << 32) | generator();
+            b[word] = ((uint64_t)generator() << 32) | generator();
+        }
+        for (size_t words = 0; words <= a.size(); words++) {
+            unsigned expected = andPopcountScalar(a.data(), b.data(), words);
+            expect_true(getAndPopcountKernel()(a.data(), b.data(), words) == expected);
+            if (andPopcountAVX2Supported()) {
+                expect_true(andPopcountAVX2(a.data(), b.data(), words) == expected);
+            }
+        }
+    }
+}
@@ -0,0 +1,76 @@
+#include <testthat.h>
+#include <iostream>
+
+#include "../Pattern/PatternIndex.h"
+#include "../Pattern/Pattern.h"
+#include "../Pattern/PatternWrongSizeException.hpp"
+#include "../Utils/Utils.h"
+
+context("PatternIndex") {
+    test_that("expand lists all unambigious kmers") {
+        std::vector<uint64_t> kmers = Pattern::expand("ACANB");
+        expect_true(kmers.size() == 12);
+        Pattern pattern("ACANB");
+        for (uint64_t kmer : kmers) {
+            expect_true(pattern.check(kmer));
+        }
+    }
+
+    test_that("index agrees with patterns") {
+        unsigned k = 5;
+        std::vector<std::string> strPatterns({"ACANB", "TTTTT", "GTNAC", "ACACC"});
+        PatternIndex index(strPatterns, k, true);
+        expect_true(index.size() == strPatterns.size());
+
+        std::vector<Pattern> patterns;
+        for (auto strPattern : strPatterns) {
+            patterns.push_back(Pattern(strPattern));
+        }
+
+        for (unsigned kmer = 0; kmer < Utils::getKmersTotal(k); kmer++) {
+            auto found = index.find(kmer);
+            unsigned matchesCount = 0;
+            for (unsigned patternID = 0; patternID < patterns.size(); patternID++) {
+                unsigned orientation =
+                    (patterns[patternID].check(kmer) ? PatternIndex::FORWARD : 0) |
+                    (patterns[patternID].check(Utils::reverseComplement(kmer, k)) ?
+                        PatternIndex::REVERSE : 0);
+                expect_true(index.check(kmer, patternID) == orientation);
+                matchesCount += orientation != 0;
+            }
+            expect_true(found.second - found.first == matchesCount);
+            for (auto match = found.first; match != found.second; match++) {
+                if (match + 1 != found.second) {
+                    expect_true(match->pattern < (match+1)->pattern);
+                }
+            }
+        }
+    }
+
+    test_that("palindromes match in both orientations") {
+        PatternIndex index(std::vector<std::string>({"ACGT"}), 4, true);
+        expect_true(index.check(Utils::stringToInt("ACGT"), 0) ==
+                    (PatternIndex::FORWARD | PatternIndex::REVERSE));
+        expect_true(index.getKmersCount() == 1);
+    }
+
+    test_that("without rc only forward kmers are indexed") {
+        PatternIndex index(std::vector<std::string>({"AACC"}), 4, false);
+        expect_true(index.check(Utils::stringToInt("AACC"), 0) == PatternIndex::FORWARD);
+        expect_true(index.check(Utils::stringToInt("GGTT"), 0) == 0);
+        auto found = index.find(Utils::stringToInt("GGTT"));
+        expect_true(found.first == found.second);
+    }
+
+    test_that("empty index finds nothing") {
+        PatternIndex index;
+        auto found = index.find(0);
+        expect_true(found.first == found.second);
+        expect_true(index.check(0, 0) == 0);
+    }
+
+    test_that("patterns must have kmer length") {
+        expect_error_as(PatternIndex(std::vector<std::string>({"ACG"}), 4, false),
+                        PatternWrongSizeException);
+    }
+}
@@ -0,0 +1,117 @@
+#include <testthat.h>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <random>
+
+#include "../Stats/PermutationTest.h"
+
+context("PermutationTest") {
+    const unsigned genes = 200, experiments = 4, elements = 30;
+    std::mt19937 generator(3);
+    PackedExperiments packed(genes, experiments);
+    std::vector<unsigned> sums(experiments, 0);
+    for (unsigned experiment = 0; experiment < experiments; experiment++) {
+        for (unsigned gene = 0; gene < genes; gene++) {
+            // The first 20 genes are up everywhere
+            if (gene < 20 || generator() % 10 == 0) {
+                packed.set(gene, experiment);
+                sums[experiment]++;
+            }
+        }
+    }
+    std::vector<std::vector<int> > elementGenes(elements);
+    elementGenes[0].resize(20);
+    std::iota(elementGenes[0].begin(), elementGenes[0].end(), 1);
+    for (unsigned element = 1; element < elements; element++) {
+        for (unsigned gene = 21; gene <= genes; gene++) {
+            if (generator() % 5 == 0) {
+                elementGenes[element].push_back(gene);
+            }
+        }
+    }
+    std::vector<const int *> starts;
+    std::vector<unsigned> sizes;
+    for (const auto& element : elementGenes) {
+        starts.push_back(element.data());
+        sizes.push_back(element.size());
+    }
+    PermutationTest test(packed, sums, Alternative::GREATER, starts, sizes);
+
+    test_that("permutations are reproducible") {
+        std::vector<unsigned> first(genes), second(genes), other(genes);
+        PermutationTest::permute(42, 7, first);
+        PermutationTest::permute(42, 7, second);
+        PermutationTest::permute(42, 8, other);
+        expect_true(first == second);
+        expect_false(first == other);
+        std::sort(first.begin(), first.end());
+        std::vector<unsigned> identity(genes);
+        std::iota(identity.begin(), identity.end(), 0);
+        expect_true(first == identity);
+    }
+
+    test_that("real statistics are sums of logs") {
+        HypergeometricTable table(genes);
+        std::vector<unsigned> counts(experiments);
+        packed.countUp(starts[1], sizes[1], counts.data());
+        double expected = 0;
+        for (unsigned experiment = 0; experiment < experiments; experiment++) {
+            expected -= 2 * std::log(table.fisherTest(counts[experiment], sizes[1],
+                                                      sums[experiment] - counts[experiment],
+                                                      genes - sizes[1], Alternative::GREATER));
+        }
+        expect_true(std::fabs(test.getStatistics()[1] - expected) < 1e-12 * expected);
+    }
+
+    test_that("counts don't depend on threads or runs") {
+        std::vector<unsigned> serial = test.run(5, 0, 200).leq;
+        expect_true(test.run(5, 0, 200, 4).leq == serial);
+
+        std::vector<unsigned> split = test.run(5, 0, 120, 3).leq;
+        std::vector<unsigned> rest = test.run(5, 120, 80, 2).leq;
+        for (unsigned element = 0; element < elements; element++) {
+            split[element] += rest[element];
+        }
+        expect_true(split == serial);
+        expect_false(test.run(6, 0, 200).leq == serial);
+        expect_true(test.run(5, 0, 200).permutations == std::vector<unsigned>(elements, 200));
+    }
+
+    test_that("associated elements are rarely beaten") {
+        std::vector<unsigned> leq = test.run(1, 0, 500, 2).leq;
+        expect_true(leq[0] == 0);
+        unsigned beaten = 0;
+        for (unsigned element = 1; element < elements; element++) {
+            beaten += leq[element] > 25;
+        }
+        expect_true(beaten > elements / 2);
+    }
+
+    test_that("elements stop after the limit of exceedances") {
+        std::vector<unsigned> limits(elements, 10);
+        limits[2] = 0;
+        PermutationTest::Counts counts = test.run(9, 0, 300, 1, limits);
+        expect_true(test.run(9, 0, 300, 5, limits).leq == counts.leq);
+        expect_true(test.run(9, 0, 300, 5, limits).permutations == counts.permutations);
+        expect_true(counts.leq[0] == 0);
+        expect_true(counts.permutations[0] == 300);
+        expect_true(counts.leq[2] == 0);
+        expect_true(counts.permutations[2] == 0);
+
+        unsigned stopped = 0;
+        for (unsigned element = 3; element < elements; element++) {
+            unsigned done = counts.permutations[element];
+            if (done == 300) {
+                expect_true(counts.leq[element] < 10);
+                continue;
+            }
+            stopped++;
+            // The last permutation run is the tenth exceedance
+            expect_true(counts.leq[element] == 10);
+            expect_true(test.run(9, 0, done).leq[element] == 10);
+            expect_true(test.run(9, 0, done - 1).leq[element] == 9);
+        }
+        expect_true(stopped > 0);
+    }
+}
@@ -0,0 +1,77 @@
+#include <testthat.h>
+
+#include "../DataStructures/SortedRuns.hpp"
+
+struct RunsRecord {
+    unsigned key, seq;
+};
+
+struct RunsByKey {
+    bool operator()(const RunsRecord& a, const RunsRecord& b) const { return a.key < b.key; }
+};
+
+context("SortedRuns") {
+    test_that("merge is sorted and stable across runs") {
+        SortedRuns<RunsRecord, RunsByKey> runs;
+        std::vector<RunsRecord> batch({{3, 0}, {1, 1}, {3, 2}});
+        runs.write(batch);
+        batch = std::vector<RunsRecord>({{2, 3}, {3, 4}, {1, 5}});
+        runs.write(batch);
+        batch.clear();
+        runs.write(batch);
+        expect_true(runs.count() == 3);
+        expect_true(runs.size() == 6);
+
+        std::vector<unsigned> keys, seqs;
+        runs.merge([&keys, &seqs](const RunsRecord& record) {
+            keys.push_back(record.key);
+            seqs.push_back(record.seq);
+        });
+        expect_true(keys == std::vector<unsigned>({1, 1, 2, 3, 3, 3}));
+        expect_true(seqs == std::vector<unsigned>({1, 5, 3, 0, 2, 4}));
+        expect_true(runs.empty());
+    }
+
+    test_that("runs longer than a block are read completely") {
+        SortedRuns<RunsRecord, RunsByKey> runs;
+        const unsigned size = 10000;
+        for (unsigned r = 0; r < 3; r++) {
+            std::vector<RunsRecord> batch;
+            for (unsigned i = 0; i < size; i++) {
+                batch.push_back(RunsRecord{(i * 7919 + r) % size, r});
+            }
+            runs.write(batch);
+        }
+        unsigned count = 0, last = 0;
+        bool sorted = true;
+        runs.merge([&](const RunsRecord& record) {
+            sorted = sorted && record.key >= last;
+            last = record.key;
+            count++;
+        });
+        expect_true(sorted);
+        expect_true(count == 3 * size);
+    }
+
+    test_that("more runs than open files are allowed are merged") {
+        SortedRuns<RunsRecord, RunsByKey> runs;
+        const unsigned count = 3000;
+        for (unsigned r = 0; r < count; r++) {
+            std::vector<RunsRecord> batch({{count - r, r}, {r, r}});
+            runs.write(batch);
+        }
+        std::vector<RunsRecord> merged;
+        runs.merge([&merged](const RunsRecord& record) { merged.push_back(record); });
+        bool sorted = merged.size() == 2 * count;
+        for (unsigned i = 1; i < merged.size(); i++) {
+            sorted = sorted && merged[i - 1].key <= merged[i].key;
+        }
+        expect_true(sorted);
+
+        std::vector<RunsRecord> batch({{5, 0}});
+        runs.write(batch);
+        unsigned keys = 0;
+        runs.merge([&keys](const RunsRecord& record) { keys += record.key; });
+        expect_true(keys == 5);
+    }
+}
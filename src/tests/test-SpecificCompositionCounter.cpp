@@ -4,6 +4,7 @@
 #include "fakeit.hpp"
 
 #include "../Counters/SpecificCompositionCounter.h"
+#include "../Pattern/Pattern.h"
 #include "../Utils/Utils.h"
 #include "../DataStructures/MotifPositionsSparse.h"
 
@@ -320,6 +321,14 @@ context("SpecificCompositionCounter") {
         }
     }
 
+    test_that("long kmers are rejected") {
+        DataStructureFactory factory;
+        std::vector<std::string> geneNames({"gene1"});
+        expect_error_as(SpecificCompositionCounter(factory, geneNames,
+                                                   std::vector<std::string>({"GCCG"}), 17, 0, 3),
+                        std::runtime_error);
+    }
+
     test_that("initialize fuzzy") {
         std::string patternKmer("GCCG");
         std::string kmer("GGGG");
@@ -87,5 +87,27 @@ context("SpecificMotifCounter") {
                         Method(spy, sElementInput).Using(1, _)
             ));
         };
+
+        test_that("counter with fixed-size builder works the same")
+        {
+            SpecificMotifCounterImpl<FixedIUPACMotifBuilder<1> > counter(factory, geneNames, patterns, true);
+            Mock<IDataStructure> spy(*(counter.getResult()));
+            Fake(Method(spy, sGeneInput));
+            Fake(Method(spy, sElementInput));
+
+            test_counter(counter);
+
+            CATCH_CHECK_NOTHROW(Verify(
+                        Method(spy, sGeneInput).Using(0) +
+                        Method(spy, sElementInput).Using(0, _) +
+                        Method(spy, sElementInput).Using(1, _) * 2 +
+                        Method(spy, sElementInput).Using(2, _) +
+                        Method(spy, sGeneInput).Using(1) +
+                        Method(spy, sElementInput).Using(2, _) +
+                        Method(spy, sElementInput).Using(1, _) +
+                        Method(spy, sElementInput).Using(0, _) +
+                        Method(spy, sElementInput).Using(1, _)
+            ));
+        };
     };
 }
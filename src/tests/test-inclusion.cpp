@@ -0,0 +1,67 @@
+#include <testthat.h>
+#include <random>
+#include <vector>
+
+#include "../Motifs/inclusion.h"
+
+static bool referenceIncludes(cell * pattern, cell * other, unsigned length) {
+    for (unsigned i = 0; i < length; i++) {
+        base p = getIUPAC(pattern, i), o = getIUPAC(other, i);
+        if ((o & ~p) || !(o & p)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+context("inclusion") {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<unsigned> nucleotide(0, 15);
+    std::uniform_int_distribution<unsigned> coin(0, 3);
+
+    std::vector<InclusionKernel> kernels({&includesScalar, getInclusionKernel()});
+    if (inclusionSSE2Supported()) {
+        kernels.push_back(&includesSSE2);
+    }
+    if (inclusionAVX2Supported()) {
+        kernels.push_back(&includesAVX2);
+    }
+
+    test_that("kernels agree with per-nucleotide check") {
+        for (unsigned length = 1; length <= 100; length++) {
+            unsigned cells = (length - 1) / IUPAC_PER_CELL + 1;
+            for (unsigned trial = 0; trial < 50; trial++) {
+                std::vector<cell> pattern(cells), other(cells);
+                for (unsigned i = 0; i < length; i++) {
+                    base p = nucleotide(rng) | 1 << coin(rng);
+                    putIUPAC(pattern.data(), i, p);
+                    // Mostly included nucleotides with an occasional mismatch
+                    base o = trial % 2 ? p & nucleotide(rng) : p;
+                    if (!o || coin(rng) == 0 && trial % 5 == 0) {
+                        o = nucleotide(rng);
+                    }
+                    putIUPAC(other.data(), i, o);
+                }
+                // Garbage above the motif must be ignored
+                for (unsigned i = length; i < cells * IUPAC_PER_CELL; i++) {
+                    putIUPAC(other.data(), i, nucleotide(rng));
+                }
+                bool answer = referenceIncludes(pattern.data(), other.data(), length);
+                expect_true(iupacIncludes(pattern.data(), other.data(), length) == answer);
+                for (auto kernel : kernels) {
+                    expect_true(kernel(pattern.data(), other.data(), length) == answer);
+                }
+            }
+        }
+    }
+
+    test_that("gaps are never included") {
+        std::vector<cell> pattern(5, ~(cell)0), other(5, ~(cell)0);
+        putIUPAC(other.data(), 70, 0);
+        for (auto kernel : kernels) {
+            expect_false(kernel(pattern.data(), other.data(), 80));
+            expect_true(kernel(pattern.data(), other.data(), 70));
+            expect_false(kernel(pattern.data(), other.data(), 71));
+        }
+    }
+}
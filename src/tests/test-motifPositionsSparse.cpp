@@ -60,4 +60,59 @@ context("MotifPositionsSparse") {
             };
         };
     };
+
+    test_that("gene filter drops elements before output") {
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        MotifPositionsSparse data(labelGenerator, std::vector<std::string>({"gene1", "gene2", "gene3"}));
+        data.setGeneFilter(GeneFilter(2, 2));
+        data.sGeneInput(0);
+        data.sElementInput(0, 10);
+        data.sElementInput(1, 20);
+        data.sGeneInput(1);
+        data.sElementInput(0, 11);
+        data.sElementInput(2, 21);
+        data.sElementInput(2, 31);
+        data.sGeneInput(2);
+        data.sElementInput(0, 12);
+        data.sElementInput(1, 22);
+        data.sElementInput(1, 32);
+        data.finalize();
+
+        const auto& structure = data.getStructure();
+        expect_true(structure.size() == 1);
+        expect_true(structure.at(1) == std::vector<int>({0, 2}));
+    }
+
+    test_that("spilling to disk gives the same result") {
+        std::function<std::string(unsigned)> labelGenerator =
+            [](unsigned id){return "elem" + std::to_string(id);};
+        std::vector<std::string> geneLabels({"gene1", "gene2", "gene3"});
+        MotifPositionsSparse spilled(labelGenerator, geneLabels), inMemory(labelGenerator, geneLabels);
+        spilled.setMemoryBudget(1);
+        for (unsigned gene = 0; gene < 4; gene++) {
+            for (auto * data : {&spilled, &inMemory}) {
+                data->sGeneInput(gene % 3);
+                for (unsigned i = 0; i < 10; i++) {
+                    data->sElementInput((i * 7 + gene) % 5, i);
+                }
+            }
+        }
+        spilled.finalize();
+        spilled.finalize();
+        inMemory.finalize();
+
+        expect_true(spilled.isSpilled());
+        expect_true(spilled.getStructure().empty());
+        const auto& structure = inMemory.getStructure();
+        const auto& elements = spilled.getMergedElements();
+        const auto& offsets = spilled.getMergedOffsets();
+        const auto& genes = spilled.getMergedGenes();
+        expect_true(elements == std::vector<unsigned>({0, 1, 2, 3, 4}));
+        for (unsigned i = 0; i < elements.size(); i++) {
+            std::vector<int> elementGenes(genes.begin() + offsets[i], genes.begin() + offsets[i + 1]);
+            expect_true(elementGenes == structure.at(elements[i]));
+        }
+        expect_true(spilled.getElementLabels() == inMemory.getElementLabels());
+    }
 }
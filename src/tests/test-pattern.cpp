@@ -109,4 +109,34 @@ context ("Pattern") {
         markKmers(kmers, 12, testData, SIZE);
         testAllKmers(testData, pattern2, SIZE);
     }
+
+    test_that("short patterns work") {
+        Pattern pattern("AN");
+        std::vector<unsigned> kmers = pattern.getKmers();
+        expect_true(kmers.size() == 4);
+        for (unsigned kmer = 0; kmer < 16; kmer++) {
+            expect_true(pattern.check(kmer) == (kmer < 4));
+        }
+        expect_false(pattern.check(64));
+    }
+
+    test_that("patterns longer than MASK_MAX_LENGTH are kept as kmer sets") {
+        std::string p(Pattern::MASK_MAX_LENGTH + 2, 'C');
+        p.back() = 'N';
+        Pattern pattern(p);
+        pattern.add(std::string(Pattern::MASK_MAX_LENGTH + 2, 'T'));
+        std::vector<unsigned> kmers = pattern.getKmers();
+        expect_true(kmers.size() == 5);
+        for (uint64_t kmer : Pattern::expand(p)) {
+            expect_true(pattern.check(kmer));
+        }
+        expect_true(pattern.check(Pattern::expand(std::string(Pattern::MASK_MAX_LENGTH + 2, 'T'))[0]));
+        expect_false(pattern.check(0));
+        expect_error_as(pattern.add("TTTT"), PatternWrongSizeException);
+    }
+
+    test_that("patterns longer than MAX_LENGTH throw exception") {
+        expect_error_as(Pattern(std::string(Pattern::MAX_LENGTH + 1, 'A')),
+                        PatternWrongSizeException);
+    }
 }